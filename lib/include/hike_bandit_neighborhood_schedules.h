@@ -0,0 +1,496 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+
+#ifndef HIKE_BANDIT_NEIGHBORHOOD_SCHEDULES_H
+#define HIKE_BANDIT_NEIGHBORHOOD_SCHEDULES_H
+
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include "hike_serializer.h"
+#include "hike_neighborhood_schedules.h"
+
+namespace hike
+{
+
+/**
+ * @brief Statistics of a neighborhood in a bandit neighborhood schedule.
+ */
+struct BanditNeighborhoodArm
+{
+    /**
+     * @brief Number of local searches applied with the neighborhood.
+     */
+    std::uint64_t pulls;
+
+    /**
+     * @brief Number of candidate solutions evaluated with the neighborhood.
+     */
+    std::uint64_t evaluations;
+
+    /**
+     * @brief Total loss decrease achieved with the neighborhood.
+     */
+    double improvement;
+
+    /**
+     * @brief Indicates if the neighborhood has failed to improve the current best solution.
+     */
+    bool failed;
+};
+
+/**
+ * @brief Bandit neighborhood schedule state of an optimization process.
+ */
+struct BanditNeighborhoodScheduleState
+{
+    /**
+     * @brief Statistics of each neighborhood.
+     */
+    std::vector<BanditNeighborhoodArm> arms;
+
+    /**
+     * @brief Number of local searches applied.
+     */
+    std::uint64_t pulls;
+
+    /**
+     * @brief Random number generator.
+     */
+    std::mt19937 random;
+};
+
+/**
+ * @brief Converts bandit neighborhood statistics to and from bytes.
+ *
+ * Fields are written one by one, so padding bytes are not stored.
+ */
+template<>
+class Serializer<BanditNeighborhoodArm>
+{
+
+public:
+    /**
+     * @brief Appends the bytes of the given value to the given buffer.
+     */
+    static void write(const BanditNeighborhoodArm& value, std::vector<char>& buffer)
+    {
+        Serializer<std::uint64_t>::write(value.pulls, buffer);
+        Serializer<std::uint64_t>::write(value.evaluations, buffer);
+        Serializer<double>::write(value.improvement, buffer);
+        Serializer<bool>::write(value.failed, buffer);
+    }
+
+    /**
+     * @brief Reads a value from the given bytes range.
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @param value Output value.
+     * @return true if the value has been read successfully, otherwise false.
+     */
+    static bool read(const char*& data, const char* dataEnd, BanditNeighborhoodArm& value)
+    {
+        return Serializer<std::uint64_t>::read(data, dataEnd, value.pulls) &&
+                Serializer<std::uint64_t>::read(data, dataEnd, value.evaluations) &&
+                Serializer<double>::read(data, dataEnd, value.improvement) &&
+                Serializer<bool>::read(data, dataEnd, value.failed);
+    }
+};
+
+/**
+ * @brief Converts bandit neighborhood schedule states to and from bytes.
+ */
+template<>
+class Serializer<BanditNeighborhoodScheduleState>
+{
+
+public:
+    /**
+     * @brief Appends the bytes of the given value to the given buffer.
+     */
+    static void write(const BanditNeighborhoodScheduleState& value, std::vector<char>& buffer)
+    {
+        Serializer<std::uint64_t>::write(value.arms.size(), buffer);
+
+        for(const BanditNeighborhoodArm& arm : value.arms)
+        {
+            Serializer<BanditNeighborhoodArm>::write(arm, buffer);
+        }
+
+        Serializer<std::uint64_t>::write(value.pulls, buffer);
+
+        // Random number engines are only portably serialized as text:
+        std::ostringstream randomStream;
+        randomStream << value.random;
+
+        std::string randomText = randomStream.str();
+        Serializer<std::vector<char>>::write(std::vector<char>(randomText.begin(), randomText.end()), buffer);
+    }
+
+    /**
+     * @brief Reads a value from the given bytes range.
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @param value Output value.
+     * @return true if the value has been read successfully, otherwise false.
+     */
+    static bool read(const char*& data, const char* dataEnd, BanditNeighborhoodScheduleState& value)
+    {
+        std::uint64_t armsCount;
+        std::vector<char> randomText;
+
+        // Each arm takes at least one byte, so corrupted counts are rejected before resizing:
+
+        if(! Serializer<std::uint64_t>::read(data, dataEnd, armsCount) || std::uint64_t(dataEnd - data) < armsCount)
+        {
+            return false;
+        }
+
+        value.arms.resize(std::size_t(armsCount));
+
+        for(BanditNeighborhoodArm& arm : value.arms)
+        {
+            if(! Serializer<BanditNeighborhoodArm>::read(data, dataEnd, arm))
+            {
+                return false;
+            }
+        }
+
+        if(! Serializer<std::uint64_t>::read(data, dataEnd, value.pulls) ||
+                ! Serializer<std::vector<char>>::read(data, dataEnd, randomText))
+        {
+            return false;
+        }
+
+        std::istringstream randomStream(std::string(randomText.begin(), randomText.end()));
+        randomStream >> value.random;
+        return ! randomStream.fail();
+    }
+};
+
+///@cond INTERNAL
+
+template<class Schedule>
+class _BanditNeighborhoodSchedule
+{
+
+public:
+    using Arm = BanditNeighborhoodArm;
+    using State = BanditNeighborhoodScheduleState;
+
+    /**
+     * @brief Returns the random number generator seed.
+     */
+    unsigned int getSeed() const noexcept
+    {
+        return _seed;
+    }
+
+    /**
+     * @brief Specifies the random number generator seed used by the next optimization processes.
+     */
+    void setSeed(unsigned int seed) noexcept
+    {
+        _seed = seed;
+    }
+
+    /**
+     * @brief Initializes the given state and returns its first neighborhood.
+     */
+    int first(State& state, int kmax) const
+    {
+        HIKE_ASSERT(kmax > 0);
+
+        state.arms.assign(std::size_t(kmax), Arm{ 0, 0, 0, false });
+        state.pulls = 0;
+        state.random.seed(_seed);
+        return _select(state);
+    }
+
+    /**
+     * @brief Returns the neighborhood which follows the one of the last local search.
+     * @param state Schedule state to update.
+     * @param result Result of the last local search.
+     * @param kmax Maximum neighborhood.
+     * @return Next neighborhood, or a value greater than kmax if the optimization process has finished.
+     */
+    int next(State& state, const NeighborhoodResult& result, int kmax) const
+    {
+        HIKE_ASSERT(kmax > 0);
+
+        state.arms.resize(std::size_t(kmax), Arm{ 0, 0, 0, false });
+
+        if(result.k <= kmax)
+        {
+            Arm& arm = state.arms[std::size_t(result.k - 1)];
+            ++arm.pulls;
+            arm.evaluations += result.evaluations;
+            ++state.pulls;
+
+            if(result.improved)
+            {
+                arm.improvement += result.improvement;
+
+                // The best solution has changed, so failed neighborhoods can improve it again:
+                for(Arm& otherArm : state.arms)
+                {
+                    otherArm.failed = false;
+                }
+            }
+            else
+            {
+                arm.failed = true;
+            }
+        }
+
+        return _select(state);
+    }
+
+protected:
+    unsigned int _seed;
+
+    explicit _BanditNeighborhoodSchedule(unsigned int seed) :
+        _seed(seed)
+    {
+    }
+
+    static double _getReward(const Arm& arm) noexcept
+    {
+        return arm.improvement / double(arm.evaluations ? arm.evaluations : 1);
+    }
+
+    int _select(State& state) const
+    {
+        int kmax = int(state.arms.size());
+        double maxReward = 0;
+        bool available = false;
+
+        for(int k = 1; k <= kmax; ++k)
+        {
+            const Arm& arm = state.arms[std::size_t(k - 1)];
+
+            if(! arm.failed)
+            {
+                // Untried neighborhoods are selected first, from the lowest to the highest one:
+                if(! arm.pulls)
+                {
+                    return k;
+                }
+
+                available = true;
+            }
+
+            maxReward = std::max(maxReward, _getReward(arm));
+        }
+
+        if(! available)
+        {
+            // All neighborhoods have failed since the last improvement:
+            return kmax + 1;
+        }
+
+        return static_cast<const Schedule&>(*this)._selectArm(state, maxReward);
+    }
+};
+
+///@endcond
+
+/**
+ * @brief Selects the next neighborhood with the upper confidence bound (UCB1) multi-armed bandit rule.
+ *
+ * The reward of each neighborhood is its loss decrease per evaluated candidate solution,
+ * normalized by the best reward of all neighborhoods.
+ *
+ * Neighborhoods which have failed to improve the best solution are not selected again
+ * until it is improved, and the optimization process finishes when all of them have failed.
+ *
+ * See LinearNeighborhoodSchedule for the schedules interface.
+ */
+class UCBNeighborhoodSchedule : public _BanditNeighborhoodSchedule<UCBNeighborhoodSchedule>
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param exploration Weight of the exploration term of the UCB rule.
+     * @param seed Random number generator seed.
+     */
+    explicit UCBNeighborhoodSchedule(double exploration = std::sqrt(2.0), unsigned int seed = 0) :
+        _BanditNeighborhoodSchedule<UCBNeighborhoodSchedule>(seed),
+        _exploration(exploration)
+    {
+        setExploration(exploration);
+    }
+
+    /**
+     * @brief Returns the weight of the exploration term of the UCB rule.
+     */
+    double getExploration() const noexcept
+    {
+        return _exploration;
+    }
+
+    /**
+     * @brief Specifies the weight of the exploration term of the UCB rule.
+     */
+    void setExploration(double exploration)
+    {
+        HIKE_ASSERT(exploration >= 0);
+
+        _exploration = exploration;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BanditNeighborhoodSchedule<UCBNeighborhoodSchedule>;
+
+    double _exploration;
+
+    int _selectArm(State& state, double maxReward) const
+    {
+        double logPulls = std::log(double(state.pulls));
+        double bestScore = 0;
+        int bestK = 0;
+
+        for(int k = 1, kmax = int(state.arms.size()); k <= kmax; ++k)
+        {
+            const Arm& arm = state.arms[std::size_t(k - 1)];
+
+            if(! arm.failed)
+            {
+                double reward = maxReward > 0 ? _getReward(arm) / maxReward : 0;
+                double score = reward + _exploration * std::sqrt(logPulls / double(arm.pulls));
+
+                if(! bestK || score > bestScore)
+                {
+                    bestScore = score;
+                    bestK = k;
+                }
+            }
+        }
+
+        return bestK;
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Selects the next neighborhood with the epsilon-greedy multi-armed bandit rule.
+ *
+ * The reward of each neighborhood is its loss decrease per evaluated candidate solution.
+ * With probability epsilon a random neighborhood is selected, otherwise the one with the highest reward.
+ *
+ * Neighborhoods which have failed to improve the best solution are not selected again
+ * until it is improved, and the optimization process finishes when all of them have failed.
+ *
+ * See LinearNeighborhoodSchedule for the schedules interface.
+ */
+class EpsilonGreedyNeighborhoodSchedule : public _BanditNeighborhoodSchedule<EpsilonGreedyNeighborhoodSchedule>
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param epsilon Probability of selecting a random neighborhood.
+     * @param seed Random number generator seed.
+     */
+    explicit EpsilonGreedyNeighborhoodSchedule(double epsilon = 0.1, unsigned int seed = 0) :
+        _BanditNeighborhoodSchedule<EpsilonGreedyNeighborhoodSchedule>(seed),
+        _epsilon(epsilon)
+    {
+        setEpsilon(epsilon);
+    }
+
+    /**
+     * @brief Returns the probability of selecting a random neighborhood.
+     */
+    double getEpsilon() const noexcept
+    {
+        return _epsilon;
+    }
+
+    /**
+     * @brief Specifies the probability of selecting a random neighborhood.
+     */
+    void setEpsilon(double epsilon)
+    {
+        HIKE_ASSERT(epsilon >= 0 && epsilon <= 1);
+
+        _epsilon = epsilon;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BanditNeighborhoodSchedule<EpsilonGreedyNeighborhoodSchedule>;
+
+    double _epsilon;
+
+    int _selectArm(State& state, double maxReward) const
+    {
+        HIKE_UNUSED(maxReward);
+
+        std::size_t availableCount = 0;
+
+        for(const Arm& arm : state.arms)
+        {
+            availableCount += ! arm.failed;
+        }
+
+        if(std::uniform_real_distribution<double>(0, 1)(state.random) < _epsilon)
+        {
+            std::size_t index = std::uniform_int_distribution<std::size_t>(0, availableCount - 1)(state.random);
+
+            for(int k = 1, kmax = int(state.arms.size()); k <= kmax; ++k)
+            {
+                if(! state.arms[std::size_t(k - 1)].failed && ! index--)
+                {
+                    return k;
+                }
+            }
+        }
+
+        double bestReward = 0;
+        int bestK = 0;
+
+        for(int k = 1, kmax = int(state.arms.size()); k <= kmax; ++k)
+        {
+            const Arm& arm = state.arms[std::size_t(k - 1)];
+
+            if(! arm.failed && (! bestK || _getReward(arm) > bestReward))
+            {
+                bestReward = _getReward(arm);
+                bestK = k;
+            }
+        }
+
+        return bestK;
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
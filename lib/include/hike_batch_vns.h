@@ -0,0 +1,336 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_BATCH_VNS_H
+#define HIKE_BATCH_VNS_H
+
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <functional>
+#include "hike_thread_pool.h"
+
+namespace hike
+{
+
+/**
+ * @brief Optimizes many independent problems in parallel, one variable neighborhood search per problem.
+ *
+ * Neighborhoods of small problems are too small to be searched in parallel, so this class parallelizes
+ * across problems instead: each thread takes chunks of problems from a shared counter and optimizes them
+ * sequentially with its own copy of the given VNS object (and of its local search and loss function),
+ * so it must be copyable.
+ *
+ * VNS object copies are reused between problems and optimizations. If their loss functions depend on per-problem
+ * parameters, they can be updated before each problem with a setup function (a cached loss function must start
+ * a new epoch then, see CachedLossFunction::nextEpoch).
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ */
+template<class Solution, class VNS>
+class BatchVNS
+{
+
+public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename VNS::LossType;
+
+    /**
+     * @brief Optimization result of a problem.
+     */
+    struct Result
+    {
+        /**
+         * @brief Best solution found.
+         */
+        Solution solution;
+
+        /**
+         * @brief Loss of the best solution found.
+         */
+        LossType loss;
+
+        /**
+         * @brief Indicates if the initial solution has been optimized or not.
+         */
+        bool optimized;
+    };
+
+    /**
+     * @brief Class constructor which uses the number of concurrent threads supported by the implementation.
+     * @param vns VNS object copied by each thread.
+     */
+    template<class VNSType>
+    explicit BatchVNS(VNSType&& vns) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<BatchTask>()),
+        _chunkSize(8)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param vns VNS object copied by each thread.
+     * @param threads Number of threads used to optimize the problems.
+     */
+    template<class VNSType>
+    BatchVNS(VNSType&& vns, unsigned int threads) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<BatchTask>(threads)),
+        _chunkSize(8)
+    {
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each thread.
+     */
+    const VNS& getVNS() const noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each thread.
+     *
+     * If it is modified after an optimization, resetVNSCopies must be called.
+     */
+    VNS& getVNS() noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::getSpinCount).
+     */
+    int getSpinCount() const noexcept
+    {
+        return _threadPool->getSpinCount();
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::setSpinCount).
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        _threadPool->setSpinCount(spinCount);
+    }
+
+    /**
+     * @brief Indicates if the calling thread optimizes pending problems too instead of waiting for the managed threads
+     * (see ThreadPool::isCallerParticipationEnabled).
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _threadPool->isCallerParticipationEnabled();
+    }
+
+    /**
+     * @brief Specifies if the calling thread optimizes pending problems too instead of waiting for the managed threads
+     * (disabled by default, see ThreadPool::setCallerParticipationEnabled).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _threadPool->setCallerParticipationEnabled(enabled);
+    }
+
+    /**
+     * @brief Destroys the VNS object copies of each thread, so they are created again on the next optimization.
+     */
+    void resetVNSCopies()
+    {
+        _vnsCopies.clear();
+    }
+
+    /**
+     * @brief Returns the number of problems taken by a thread at once.
+     */
+    std::size_t getChunkSize() const noexcept
+    {
+        return _chunkSize;
+    }
+
+    /**
+     * @brief Specifies the number of problems taken by a thread at once (8 by default).
+     *
+     * Bigger chunks reduce contention on the shared counter, and smaller ones balance the load between threads better.
+     */
+    void setChunkSize(std::size_t chunkSize)
+    {
+        HIKE_ASSERT(chunkSize > 0);
+
+        _chunkSize = chunkSize;
+    }
+
+    /**
+     * @brief Minimizes the loss function of each problem.
+     * @param solutionsFirst Random access iterator to the initial solution of the first problem.
+     * @param solutionsLast Random access iterator past the initial solution of the last problem.
+     * @param resultsFirst Random access iterator to the output range which receives the result (see Result)
+     * of each problem, in the same order as the initial solutions.
+     */
+    template<class SolutionIterator, class ResultIterator>
+    void optimize(SolutionIterator solutionsFirst, SolutionIterator solutionsLast, ResultIterator resultsFirst)
+    {
+        _optimize(std::size_t(solutionsLast - solutionsFirst), [solutionsFirst, resultsFirst](VNS& vns,
+                  std::size_t index)
+        {
+            _optimizeProblem(vns, solutionsFirst[index], resultsFirst[index]);
+        });
+    }
+
+    /**
+     * @brief Minimizes the loss function of each problem with its own parameters.
+     * @param solutionsFirst Random access iterator to the initial solution of the first problem.
+     * @param solutionsLast Random access iterator past the initial solution of the last problem.
+     * @param paramsFirst Random access iterator to the parameters of the first problem.
+     * @param resultsFirst Random access iterator to the output range which receives the result (see Result)
+     * of each problem, in the same order as the initial solutions.
+     * @param setup Function called with the VNS object copy of a thread and the parameters of a problem
+     * before optimizing it.
+     */
+    template<class SolutionIterator, class ParamsIterator, class ResultIterator, class Setup>
+    void optimize(SolutionIterator solutionsFirst, SolutionIterator solutionsLast, ParamsIterator paramsFirst,
+                  ResultIterator resultsFirst, Setup setup)
+    {
+        _optimize(std::size_t(solutionsLast - solutionsFirst), [solutionsFirst, paramsFirst, resultsFirst, &setup](
+                  VNS& vns, std::size_t index)
+        {
+            setup(vns, paramsFirst[index]);
+            _optimizeProblem(vns, solutionsFirst[index], resultsFirst[index]);
+        });
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    using ProblemFunction = std::function<void(VNS&, std::size_t)>;
+
+    class BatchTask
+    {
+
+    public:
+        BatchTask(BatchVNS& batchVNS, std::size_t threadIndex) :
+            _batchVNS(batchVNS),
+            _threadIndex(threadIndex)
+        {
+        }
+
+        void operator()()
+        {
+            _batchVNS._run(_threadIndex);
+        }
+
+    protected:
+        BatchVNS& _batchVNS;
+        std::size_t _threadIndex;
+    };
+
+    VNS _vns;
+    std::unique_ptr<ThreadPool<BatchTask>> _threadPool;
+    std::vector<std::unique_ptr<VNS>> _vnsCopies;
+    std::size_t _chunkSize;
+
+    const ProblemFunction* _problemFunction;
+    std::size_t _problemsCount;
+    std::atomic<std::size_t> _nextProblemIndex;
+
+    void _optimize(std::size_t problemsCount, const ProblemFunction& problemFunction)
+    {
+        if(! problemsCount)
+        {
+            return;
+        }
+
+        std::size_t threadsCount = _threadPool->getThreadsCount();
+
+        if(_vnsCopies.empty())
+        {
+            _vnsCopies.reserve(threadsCount);
+
+            for(std::size_t threadIndex = 0; threadIndex < threadsCount; ++threadIndex)
+            {
+                _vnsCopies.emplace_back(new VNS(_vns));
+            }
+        }
+
+        _problemFunction = &problemFunction;
+        _problemsCount = problemsCount;
+        _nextProblemIndex.store(0, std::memory_order_relaxed);
+
+        // Threads which find no chunks left return immediately:
+
+        std::size_t tasksCount = std::min(threadsCount, (problemsCount + _chunkSize - 1) / _chunkSize);
+
+        for(std::size_t threadIndex = 0; threadIndex < tasksCount; ++threadIndex)
+        {
+            _threadPool->add(BatchTask(*this, threadIndex));
+        }
+
+        _threadPool->join();
+    }
+
+    void _run(std::size_t threadIndex)
+    {
+        VNS& vns = *_vnsCopies[threadIndex];
+
+        while(true)
+        {
+            std::size_t first = _nextProblemIndex.fetch_add(_chunkSize, std::memory_order_relaxed);
+
+            if(first >= _problemsCount)
+            {
+                return;
+            }
+
+            std::size_t last = std::min(first + _chunkSize, _problemsCount);
+
+            for(std::size_t index = first; index < last; ++index)
+            {
+                (*_problemFunction)(vns, index);
+            }
+        }
+    }
+
+    template<class SolutionType>
+    static void _optimizeProblem(VNS& vns, const SolutionType& solution, Result& result)
+    {
+        typename VNS::State state = vns.createState(solution);
+
+        while(! vns.iterate(state, std::numeric_limits<int>::max()))
+        {
+        }
+
+        result.solution = std::move(state.solution);
+        result.loss = state.loss;
+        result.optimized = state.optimized;
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
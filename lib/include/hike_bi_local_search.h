@@ -19,6 +19,8 @@
 #ifndef HIKE_BI_LOCAL_SEARCH_H
 #define HIKE_BI_LOCAL_SEARCH_H
 
+#include <vector>
+#include <algorithm>
 #include "hike_local_search_base.h"
 #include "hike_empty_on_improved_solution.h"
 
@@ -62,10 +64,58 @@ public:
                   OnImprovedSolutionType&& onImprovedSolution, int neighborhood = 1) :
         _BaseClass(std::forward<LossFunctionType>(lossFunction),
                    std::forward<OnImprovedSolutionType>(onImprovedSolution), neighborhood),
-        _stepSolution(std::forward<SolutionType>(stepSolution))
+        _stepSolution(std::forward<SolutionType>(stepSolution)),
+        _solution(),
+        _candidatesCount(0),
+        _surrogateCandidates(0)
     {
     }
 
+    /**
+     * @brief Returns the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     */
+    const Solution& getStepSolution() const noexcept
+    {
+        return _stepSolution;
+    }
+
+    /**
+     * @brief Specifies the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     *
+     * Parameters with a zero step are not changed, so the search can be restricted to a subset of parameters
+     * (see VNDS).
+     */
+    void setStepSolution(const Solution& stepSolution)
+    {
+        _stepSolution = stepSolution;
+    }
+
+    /**
+     * @brief Returns the maximum number of candidate solutions whose exact loss is calculated in each step
+     * if the loss function provides surrogate losses (see HasSurrogate).
+     *
+     * If it is greater than zero, all candidate solutions are sorted by their surrogate loss,
+     * and only the exact loss of the best ones is calculated. Zero means that surrogate losses are not used.
+     */
+    std::size_t getSurrogateCandidates() const noexcept
+    {
+        return _surrogateCandidates;
+    }
+
+    /**
+     * @brief Specifies the maximum number of candidate solutions whose exact loss is calculated in each step
+     * if the loss function provides surrogate losses (see HasSurrogate).
+     *
+     * If it is greater than zero, all candidate solutions are sorted by their surrogate loss,
+     * and only the exact loss of the best ones is calculated. Zero means that surrogate losses are not used.
+     */
+    void setSurrogateCandidates(std::size_t surrogateCandidates)
+    {
+        _surrogateCandidates = surrogateCandidates;
+    }
+
     /**
      * @brief optimize Minimizes the loss function with the given solution.
      * @param solution The solution to optimize.
@@ -90,19 +140,159 @@ public:
         HIKE_ASSERT(solution.size() == _stepSolution.size());
 
         Solution bestSolution = solution;
-        auto bestLoss = _BaseClass::_lossFunction(bestSolution);
-        optimized = false;
-        _optimize<false>(0, bestLoss, solution, bestSolution, optimized);
+        _optimizeSolution(solution, bestSolution, optimized);
 
         return bestSolution;
     }
 
+    /**
+     * @brief optimize Minimizes the loss function with the given solution,
+     * reusing the memory of the output solution.
+     * @param solution The solution to optimize.
+     * @param optimizedSolution Output parameter which contains the optimized solution.
+     * @param optimized Output parameter which indicates if the given solution has been optimized or not.
+     */
+    void optimize(const Solution& solution, Solution& optimizedSolution, bool& optimized)
+    {
+        HIKE_ASSERT(solution.size() == _stepSolution.size());
+
+        _solution = solution;
+        optimizedSolution = solution;
+        _optimizeSolution(_solution, optimizedSolution, optimized);
+    }
+
 protected:
     ///@cond INTERNAL
 
     using _BaseClass = LocalSearchBase<LossFunction, OnImprovedSolution>;
 
+    using SurrogateLoss = SurrogateLossType<LossFunction, Solution>;
+
     Solution _stepSolution;
+    Solution _solution;
+    std::vector<Solution> _candidates;
+    std::size_t _candidatesCount;
+    std::vector<std::pair<SurrogateLoss, std::size_t>> _surrogateLosses;
+    std::size_t _surrogateCandidates;
+
+    void _optimizeSolution(Solution& solution, Solution& bestSolution, bool& optimized)
+    {
+        auto bestLoss = _BaseClass::_lossFunction(bestSolution);
+        optimized = false;
+
+        if(_surrogateCandidates && HasSurrogate<LossFunction, Solution>::value)
+        {
+            _optimizeWithSurrogate(bestLoss, solution, bestSolution, optimized);
+        }
+        else
+        {
+            _BaseClass::_startHashing(solution);
+            _optimize<false>(0, bestLoss, solution, bestSolution, optimized);
+            _BaseClass::_stopHashing();
+        }
+    }
+
+    template<typename LossType>
+    void _optimizeWithSurrogate(LossType& bestLoss, Solution& solution, Solution& bestSolution, bool& optimized)
+    {
+        _addCandidates(0, solution);
+
+        for(std::size_t index = 0; index < _candidatesCount; ++index)
+        {
+            _surrogateLosses.push_back(std::make_pair(_surrogate(_candidates[index]), index));
+        }
+
+        // Only the exact loss of the best candidates (sorted by their surrogate loss) is calculated:
+
+        auto lastSurrogateLossIt = _surrogateLosses.begin() +
+                std::ptrdiff_t(std::min(_surrogateCandidates, _surrogateLosses.size()));
+        std::partial_sort(_surrogateLosses.begin(), lastSurrogateLossIt, _surrogateLosses.end());
+
+        for(auto surrogateLossIt = _surrogateLosses.begin(); surrogateLossIt != lastSurrogateLossIt;
+            ++surrogateLossIt)
+        {
+            Solution& candidate = _candidates[surrogateLossIt->second];
+            auto loss = _BaseClass::_evaluate(candidate, bestLoss);
+
+            if(loss < bestLoss)
+            {
+                _BaseClass::_onImprovedSolution(bestSolution, bestLoss, candidate, loss, _BaseClass::_neighborhood);
+                bestSolution = candidate;
+                bestLoss = loss;
+                optimized = true;
+            }
+        }
+
+        _candidatesCount = 0;
+        _surrogateLosses.clear();
+    }
+
+    SurrogateLoss _surrogate(const Solution& solution)
+    {
+        return _surrogate(solution, std::integral_constant<bool, HasSurrogate<LossFunction, Solution>::value>());
+    }
+
+    SurrogateLoss _surrogate(const Solution& solution, std::true_type)
+    {
+        return _BaseClass::_lossFunction.surrogate(solution);
+    }
+
+    SurrogateLoss _surrogate(const Solution& solution, std::false_type)
+    {
+        return _BaseClass::_lossFunction(solution);
+    }
+
+    void _addCandidate(const Solution& solution)
+    {
+        // Candidate solutions are reused between steps to avoid memory allocations:
+
+        if(_candidatesCount < _candidates.size())
+        {
+            _candidates[_candidatesCount] = solution;
+        }
+        else
+        {
+            _candidates.push_back(solution);
+        }
+
+        ++_candidatesCount;
+    }
+
+    void _addCandidates(std::size_t paramIndex, Solution& solution)
+    {
+        if(paramIndex < solution.size())
+        {
+            auto currentParam = solution[paramIndex];
+            auto stepParam = _stepSolution[paramIndex] * _BaseClass::_neighborhood;
+
+            if(_BaseClass::_isFrozen(stepParam))
+            {
+                _addCandidates(paramIndex + 1, solution);
+                return;
+            }
+
+            // Previous step candidates:
+
+            solution[paramIndex] = currentParam - stepParam;
+            _addCandidate(solution);
+            _addCandidates(paramIndex + 1, solution);
+
+            // Current step candidates:
+
+            solution[paramIndex] = currentParam;
+            _addCandidates(paramIndex + 1, solution);
+
+            // Next step candidates:
+
+            solution[paramIndex] = currentParam + stepParam;
+            _addCandidate(solution);
+            _addCandidates(paramIndex + 1, solution);
+
+            // Restore solution:
+
+            solution[paramIndex] = currentParam;
+        }
+    }
 
     template<bool checkCurrentStep, typename LossType>
     void _optimize(std::size_t paramIndex, LossType& bestLoss, Solution& solution, Solution& bestSolution, bool& optimized)
@@ -112,11 +302,17 @@ protected:
             auto currentParam = solution[paramIndex];
             auto stepParam = _stepSolution[paramIndex] * _BaseClass::_neighborhood;
 
+            if(_BaseClass::_isFrozen(stepParam))
+            {
+                _optimize<checkCurrentStep>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+                return;
+            }
+
             // Previous step check:
 
-            solution[paramIndex] = currentParam - stepParam;
+            _BaseClass::_setParam(solution, paramIndex, currentParam - stepParam);
 
-            auto loss = _BaseClass::_lossFunction(solution);
+            auto loss = _BaseClass::_evaluate(solution, bestLoss);
 
             if(loss < bestLoss)
             {
@@ -126,15 +322,18 @@ protected:
                 optimized = true;
             }
 
-            _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss))
+            {
+                _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            }
 
             // Current step check:
 
-            solution[paramIndex] = currentParam;
+            _BaseClass::_setParam(solution, paramIndex, currentParam);
 
             if(checkCurrentStep)
             {
-                loss = _BaseClass::_lossFunction(solution);
+                loss = _BaseClass::_evaluate(solution, bestLoss);
 
                 if(loss < bestLoss)
                 {
@@ -145,12 +344,15 @@ protected:
                 }
             }
 
-            _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss))
+            {
+                _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            }
 
             // Next step check:
 
-            solution[paramIndex] = currentParam + stepParam;
-            loss = _BaseClass::_lossFunction(solution);
+            _BaseClass::_setParam(solution, paramIndex, currentParam + stepParam);
+            loss = _BaseClass::_evaluate(solution, bestLoss);
 
             if(loss < bestLoss)
             {
@@ -160,11 +362,14 @@ protected:
                 optimized = true;
             }
 
-            _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss))
+            {
+                _optimize<true>(paramIndex + 1, bestLoss, solution, bestSolution, optimized);
+            }
 
             // Restore solution:
 
-            solution[paramIndex] = currentParam;
+            _BaseClass::_setParam(solution, paramIndex, currentParam);
         }
     }
 
@@ -19,15 +19,31 @@
 #ifndef HIKE_CACHED_LOSS_FUNCTION_H
 #define HIKE_CACHED_LOSS_FUNCTION_H
 
-#include <unordered_map>
+#include <memory>
+#include <cstring>
+#include <functional>
+#include "hike_loss_function_traits.h"
+#include "hike_serializer.h"
+#include "hike_solution_hash.h"
+#include "hike_solution_map.h"
+#include "hike_zobrist_hash.h"
 
 namespace hike
 {
 
 /**
  * @brief Remembers previously calculated losses.
+ *
+ * If the child loss function changes over time, nextEpoch must be called to invalidate the cached losses.
+ *
+ * Solutions are identified with the given SolutionHash, which by default supports containers
+ * of arithmetic parameters and falls back to std::hash otherwise. Only with ZobristHash, local searches pass
+ * their candidate solutions already hashed (see HasHashedLoss), so cache lookups don't hash them again.
+ *
+ * Cache entries are allocated with the given Allocator (see PoolAllocator).
  */
-template<class Solution, class LossFunction, class SolutionHash = std::hash<Solution>>
+template<class Solution, class LossFunction, class SolutionHash = hike::SolutionHash<Solution>,
+         class Allocator = std::allocator<Solution>>
 class CachedLossFunction
 {
 
@@ -42,7 +58,10 @@ public:
      * @param lossFunction Loss function used to calculate the loss of new solutions.
      */
     explicit CachedLossFunction(const LossFunction& lossFunction) :
-        _lossFunction(lossFunction)
+        _lossFunction(lossFunction),
+        _epoch(1),
+        _reclaimBucketCount(0),
+        _reclaimPending(false)
     {
     }
 
@@ -51,33 +70,412 @@ public:
      * @param lossFunction Loss function used to calculate the loss of new solutions.
      */
     explicit CachedLossFunction(LossFunction&& lossFunction) :
-        _lossFunction(std::move(lossFunction))
+        _lossFunction(std::move(lossFunction)),
+        _epoch(1),
+        _reclaimBucketCount(0),
+        _reclaimPending(false)
     {
     }
 
+    /**
+     * @brief Class constructor.
+     * @param lossFunction Loss function used to calculate the loss of new solutions.
+     * @param allocator Allocator used to allocate cache entries.
+     */
+    CachedLossFunction(const LossFunction& lossFunction, const Allocator& allocator) :
+        _lossFunction(lossFunction),
+        _losses(allocator),
+        _epoch(1),
+        _reclaimBucketCount(0),
+        _reclaimPending(false)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param lossFunction Loss function used to calculate the loss of new solutions.
+     * @param allocator Allocator used to allocate cache entries.
+     */
+    CachedLossFunction(LossFunction&& lossFunction, const Allocator& allocator) :
+        _lossFunction(std::move(lossFunction)),
+        _losses(allocator),
+        _epoch(1),
+        _reclaimBucketCount(0),
+        _reclaimPending(false)
+    {
+    }
+
+    /**
+     * @brief Copy constructor.
+     */
+    CachedLossFunction(const CachedLossFunction& other) :
+        _lossFunction(other._lossFunction),
+        _losses(other._losses),
+        _epoch(other._epoch),
+        _reclaimPending(other._reclaimPending)
+    {
+        _restartReclaim();
+    }
+
+    /**
+     * @brief Move constructor.
+     */
+    CachedLossFunction(CachedLossFunction&& other) :
+        _lossFunction(std::move(other._lossFunction)),
+        _losses(std::move(other._losses)),
+        _epoch(other._epoch),
+        _reclaimPending(other._reclaimPending)
+    {
+        _restartReclaim();
+        other._restartReclaim();
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     */
+    CachedLossFunction& operator=(const CachedLossFunction& other)
+    {
+        if(this != &other)
+        {
+            _lossFunction = other._lossFunction;
+            _losses = other._losses;
+            _epoch = other._epoch;
+            _reclaimPending = other._reclaimPending;
+            _restartReclaim();
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     */
+    CachedLossFunction& operator=(CachedLossFunction&& other)
+    {
+        if(this != &other)
+        {
+            _lossFunction = std::move(other._lossFunction);
+            _losses = std::move(other._losses);
+            _epoch = other._epoch;
+            _reclaimPending = other._reclaimPending;
+            _restartReclaim();
+            other._restartReclaim();
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Returns the current epoch of the cache.
+     */
+    std::uint64_t getEpoch() const noexcept
+    {
+        return _epoch;
+    }
+
+    /**
+     * @brief Starts a new epoch, so losses calculated before are not returned anymore.
+     *
+     * It must be called when the child loss function changes. Losses of the previous epoch are only available
+     * as hints (see findHint), and older ones are reclaimed lazily when new losses are cached.
+     */
+    void nextEpoch()
+    {
+        ++_epoch;
+        _reclaimIt = _losses.begin();
+        _reclaimBucketCount = _losses.bucket_count();
+        _reclaimPending = true;
+    }
+
+    /**
+     * @brief Returns the number of cached losses, including the ones which have not been reclaimed yet.
+     */
+    std::size_t getCachedLossesCount() const noexcept
+    {
+        return _losses.size();
+    }
+
+    /**
+     * @brief Searches a cached loss of the given solution from the current or the previous epoch.
+     *
+     * Hints can be used to order candidate solutions or as approximate losses, but they can be stale
+     * or lower bounds only.
+     *
+     * @param solution Solution to search.
+     * @param loss Output parameter which contains the cached loss if it has been found.
+     * @return true if a cached loss has been found, otherwise false.
+     */
+    bool findHint(const Solution& solution, LossType& loss) const
+    {
+        auto lossIt = _losses.find(solution, _losses.hash(solution));
+
+        if(lossIt == _losses.end() || lossIt->second.value.epoch + 1 < _epoch)
+        {
+            return false;
+        }
+
+        loss = lossIt->second.value.loss;
+        return true;
+    }
+
     /**
      * @brief Returns the loss of the given solution.
      */
     LossType operator()(const Solution& solution)
     {
-        auto lossIt = _losses.find(solution);
+        std::size_t hash = _losses.hash(solution);
+        auto lossIt = _losses.find(solution, hash);
 
         if(lossIt != _losses.end())
         {
-            return lossIt->second;
+            CachedLoss& cachedLoss = lossIt->second.value;
+
+            if(cachedLoss.epoch != _epoch || ! cachedLoss.exact)
+            {
+                // The loss is stale or only a lower bound of it is known, so it must be calculated:
+
+                cachedLoss.loss = _lossFunction(solution);
+                cachedLoss.exact = true;
+                cachedLoss.epoch = _epoch;
+            }
+
+            return cachedLoss.loss;
         }
 
         auto loss = _lossFunction(solution);
-        _losses.insert(std::make_pair(solution, loss));
+        _insert(solution, hash, CachedLoss{ loss, true, _epoch });
 
         return loss;
     }
 
+    /**
+     * @brief Returns the loss of the given solution if it is lower than the given cutoff value.
+     * Otherwise, it returns a value not lower than the cutoff value.
+     *
+     * The cutoff value is passed to the child loss function if it supports it (see HasCutoff).
+     * In that case, returned losses not lower than the cutoff value are cached as lower bounds only.
+     */
+    LossType operator()(const Solution& solution, const LossType& cutoff)
+    {
+        return _loss(solution, _losses.hash(solution), cutoff);
+    }
+
+    /**
+     * @brief Returns the loss of the given solution, whose hash is already known (see HasHashedLoss),
+     * if it is lower than the given cutoff value. Otherwise, it returns a value not lower than the cutoff value.
+     *
+     * It is available only if SolutionHash is ZobristHash, so known hashes are always valid cache keys.
+     */
+    template<class SolutionHashType = SolutionHash>
+    auto hashedLoss(const HashedSolution<Solution>& hashedSolution, const LossType& cutoff)
+        -> typename std::enable_if<std::is_same<SolutionHashType, ZobristHash<Solution>>::value, LossType>::type
+    {
+        return _loss(hashedSolution.solution, hashedSolution.hash, cutoff);
+    }
+
+    /**
+     * @brief Appends the cached losses of the current and the previous epoch to the given buffer,
+     * so they can be restored later with load.
+     *
+     * Solutions and losses are converted to bytes with the given serializers (see Serializer).
+     */
+    template<class SolutionSerializer = Serializer<Solution>, class LossSerializer = Serializer<LossType>>
+    void save(std::vector<char>& buffer) const
+    {
+        std::size_t lossesCountPosition = buffer.size();
+        std::uint64_t lossesCount = 0;
+        Serializer<std::uint64_t>::write(lossesCount, buffer);
+
+        for(const auto& solutionAndLoss : _losses)
+        {
+            const CachedLoss& cachedLoss = solutionAndLoss.second.value;
+
+            if(cachedLoss.epoch + 1 >= _epoch)
+            {
+                SolutionSerializer::write(solutionAndLoss.second.solution, buffer);
+                LossSerializer::write(cachedLoss.loss, buffer);
+                Serializer<bool>::write(cachedLoss.exact, buffer);
+                Serializer<bool>::write(cachedLoss.epoch == _epoch, buffer);
+                ++lossesCount;
+            }
+        }
+
+        std::memcpy(buffer.data() + lossesCountPosition, &lossesCount, sizeof(lossesCount));
+    }
+
+    /**
+     * @brief Adds the cached losses stored by save to this cache.
+     *
+     * Losses of the current epoch of the saved cache are added to the current epoch of this one,
+     * and the other ones to the previous epoch.
+     *
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @return true if the cached losses have been read successfully, otherwise false.
+     */
+    template<class SolutionSerializer = Serializer<Solution>, class LossSerializer = Serializer<LossType>>
+    bool load(const char*& data, const char* dataEnd)
+    {
+        std::uint64_t lossesCount;
+
+        if(! Serializer<std::uint64_t>::read(data, dataEnd, lossesCount))
+        {
+            return false;
+        }
+
+        Solution solution;
+        LossType loss;
+        bool exact;
+        bool current;
+
+        for(std::uint64_t index = 0; index < lossesCount; ++index)
+        {
+            if(! SolutionSerializer::read(data, dataEnd, solution) || ! LossSerializer::read(data, dataEnd, loss) ||
+                    ! Serializer<bool>::read(data, dataEnd, exact) || ! Serializer<bool>::read(data, dataEnd, current))
+            {
+                return false;
+            }
+
+            _store(solution, CachedLoss{ loss, exact, current ? _epoch : _epoch - 1 });
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns a lower bound of the loss of the solutions
+     * whose parameters in the range [0, paramIndex] are equal to the given solution ones.
+     *
+     * It is available only if the child loss function provides lower bounds (see HasLowerBound).
+     */
+    template<class LossFunctionType = LossFunction>
+    auto lowerBound(const Solution& solution, std::size_t paramIndex)
+        -> decltype(std::declval<LossFunctionType&>().lowerBound(solution, paramIndex))
+    {
+        return _lossFunction.lowerBound(solution, paramIndex);
+    }
+
+    /**
+     * @brief Returns a cheap approximation of the loss of the given solution, which is not cached.
+     *
+     * It is available only if the child loss function provides surrogate losses (see HasSurrogate).
+     */
+    template<class LossFunctionType = LossFunction>
+    auto surrogate(const Solution& solution) -> decltype(std::declval<LossFunctionType&>().surrogate(solution))
+    {
+        return _lossFunction.surrogate(solution);
+    }
+
 protected:
     ///@cond INTERNAL
 
+    struct CachedLoss
+    {
+        LossType loss;
+        bool exact;
+        std::uint64_t epoch;
+    };
+
+    using Losses = _SolutionMap<Solution, CachedLoss, SolutionHash, Allocator>;
+
     LossFunction _lossFunction;
-    std::unordered_map<Solution, LossType, SolutionHash> _losses;
+    Losses _losses;
+    std::uint64_t _epoch;
+    typename Losses::iterator _reclaimIt;
+    std::size_t _reclaimBucketCount;
+    bool _reclaimPending;
+
+    LossType _loss(const Solution& solution, std::size_t hash, const LossType& cutoff)
+    {
+        auto lossIt = _losses.find(solution, hash);
+
+        if(lossIt != _losses.end())
+        {
+            CachedLoss& cachedLoss = lossIt->second.value;
+
+            if(cachedLoss.epoch == _epoch && (cachedLoss.exact || ! (cachedLoss.loss < cutoff)))
+            {
+                return cachedLoss.loss;
+            }
+
+            cachedLoss.loss = evaluateLoss(_lossFunction, solution, cutoff);
+            cachedLoss.exact = _isExact(cachedLoss.loss, cutoff);
+            cachedLoss.epoch = _epoch;
+            return cachedLoss.loss;
+        }
+
+        auto loss = evaluateLoss(_lossFunction, solution, cutoff);
+        _insert(solution, hash, CachedLoss{ loss, _isExact(loss, cutoff), _epoch });
+
+        return loss;
+    }
+
+    void _store(const Solution& solution, const CachedLoss& cachedLoss)
+    {
+        std::size_t hash = _losses.hash(solution);
+        auto lossIt = _losses.find(solution, hash);
+
+        if(lossIt == _losses.end())
+        {
+            _insert(solution, hash, cachedLoss);
+        }
+        else if(cachedLoss.epoch > lossIt->second.value.epoch ||
+                (cachedLoss.epoch == lossIt->second.value.epoch &&
+                 (cachedLoss.exact || ! lossIt->second.value.exact)))
+        {
+            // Exact losses replace lower bounds, but lower bounds never replace exact losses of the same epoch:
+
+            lossIt->second.value = cachedLoss;
+        }
+    }
+
+    void _insert(const Solution& solution, std::size_t hash, const CachedLoss& cachedLoss)
+    {
+        _reclaim();
+        _losses.insert(solution, hash, cachedLoss);
+
+        if(_reclaimPending && _losses.bucket_count() != _reclaimBucketCount)
+        {
+            // Rehashing invalidates the reclaim iterator, so the reclaim starts again:
+
+            _reclaimIt = _losses.begin();
+            _reclaimBucketCount = _losses.bucket_count();
+        }
+    }
+
+    void _restartReclaim()
+    {
+        // The reclaim iterator points into the map of the object which set it, so copies start the reclaim again:
+
+        _reclaimIt = _losses.begin();
+        _reclaimBucketCount = _losses.bucket_count();
+    }
+
+    void _reclaim()
+    {
+        // Losses older than the previous epoch are erased a few at a time, so starting a new epoch is cheap:
+
+        for(int count = 0; _reclaimPending && count < 2; ++count)
+        {
+            if(_reclaimIt == _losses.end())
+            {
+                _reclaimPending = false;
+            }
+            else if(_reclaimIt->second.value.epoch + 1 < _epoch)
+            {
+                _reclaimIt = _losses.erase(_reclaimIt);
+            }
+            else
+            {
+                ++_reclaimIt;
+            }
+        }
+    }
+
+    static bool _isExact(const LossType& loss, const LossType& cutoff)
+    {
+        return ! HasCutoff<LossFunction, Solution>::value || loss < cutoff;
+    }
 
     ///@endcond
 };
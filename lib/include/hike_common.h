@@ -21,6 +21,10 @@
 
 #include <cassert>
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    #include <intrin.h>
+#endif
+
 /**
  * Mathematical optimization library.
  *
@@ -35,6 +39,17 @@ namespace hike
 // Unused variable macro:
 #define HIKE_UNUSED(variable) (void)(variable)
 
+// CPU pause macro, used in spin-wait loops:
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    #define HIKE_CPU_PAUSE() _mm_pause()
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #define HIKE_CPU_PAUSE() __builtin_ia32_pause()
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+    #define HIKE_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+    #define HIKE_CPU_PAUSE() (void)0
+#endif
+
 }
 
 #endif
@@ -0,0 +1,384 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_ISLAND_VNS_H
+#define HIKE_ISLAND_VNS_H
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <vector>
+#include <utility>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Parallel variable neighborhood search which runs one VNS per thread (island),
+ * each one of them from a different initial solution.
+ *
+ * Every given number of iterations, each island sends its best solution to the next one,
+ * which replaces its own best solution with the received one if it is better.
+ *
+ * Migrants are exchanged through lock-free mailboxes, and their storage is reused by later migrations.
+ * Islands which have finished wait for migrants on a condition variable, which is only notified
+ * if some island is waiting, so running islands never lock a mutex.
+ *
+ * Each island uses its own copy of the given VNS object (and of its local search and loss function),
+ * so it must be copyable.
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ */
+template<class Solution, class VNS>
+class IslandVNS
+{
+
+public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename VNS::LossType;
+
+    /**
+     * @brief Class constructor.
+     * @param vns VNS object copied by each island.
+     * @param migrationIterations Number of local searches applied by each island between migrations.
+     */
+    template<class VNSType>
+    IslandVNS(VNSType&& vns, int migrationIterations) :
+        _vns(std::forward<VNSType>(vns))
+    {
+        setMigrationIterations(migrationIterations);
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each island.
+     */
+    const VNS& getVNS() const noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each island.
+     */
+    VNS& getVNS() noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the number of local searches applied by each island between migrations.
+     */
+    int getMigrationIterations() const noexcept
+    {
+        return _migrationIterations;
+    }
+
+    /**
+     * @brief Specifies the number of local searches applied by each island between migrations.
+     */
+    void setMigrationIterations(int migrationIterations)
+    {
+        HIKE_ASSERT(migrationIterations > 0);
+
+        _migrationIterations = migrationIterations;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solutions.
+     * @param solutions Initial solutions, one per island.
+     * @return The best optimized solution.
+     */
+    Solution optimize(const std::vector<Solution>& solutions)
+    {
+        bool optimized;
+
+        return optimize(solutions, optimized);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solutions.
+     * @param solutions Initial solutions, one per island.
+     * @param optimized Output parameter which indicates if the best input solution has been optimized or not.
+     * @return The best optimized solution.
+     */
+    Solution optimize(const std::vector<Solution>& solutions, bool& optimized)
+    {
+        HIKE_ASSERT(! solutions.empty());
+
+        std::size_t islandsCount = solutions.size();
+        std::vector<std::unique_ptr<Island>> islands;
+        Migrations migrations(islandsCount);
+        islands.reserve(islandsCount);
+
+        for(const Solution& solution : solutions)
+        {
+            islands.emplace_back(new Island(_vns, solution));
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(islandsCount);
+
+        for(std::size_t index = 0; index < islandsCount; ++index)
+        {
+            Island& island = *islands[index];
+            Island& nextIsland = *islands[(index + 1) % islandsCount];
+
+            threads.emplace_back([this, &island, &nextIsland, &migrations]
+            {
+                _run(island, nextIsland, migrations);
+            });
+        }
+
+        for(std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Select the best island:
+
+        Island* bestIsland = islands[0].get();
+        auto bestInputLoss = bestIsland->inputLoss;
+
+        for(std::size_t index = 1; index < islandsCount; ++index)
+        {
+            Island* island = islands[index].get();
+
+            if(island->state.loss < bestIsland->state.loss)
+            {
+                bestIsland = island;
+            }
+
+            if(island->inputLoss < bestInputLoss)
+            {
+                bestInputLoss = island->inputLoss;
+            }
+        }
+
+        optimized = bestIsland->state.loss < bestInputLoss;
+        return std::move(bestIsland->state.solution);
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    struct Migrant
+    {
+        Solution solution;
+        LossType loss;
+    };
+
+    struct Island
+    {
+        VNS vns;
+        typename VNS::State state;
+        LossType inputLoss;
+
+        // Migrant sent by the previous island which has not been received yet:
+        std::atomic<Migrant*> mailbox;
+
+        // Storage of the last received migrant, reused by the previous island to send the next one:
+        std::atomic<Migrant*> spareMigrant;
+
+        Island(const VNS& islandVNS, const Solution& solution) :
+            vns(islandVNS),
+            state(vns.createState(solution)),
+            inputLoss(state.loss),
+            mailbox(nullptr),
+            spareMigrant(nullptr)
+        {
+        }
+
+        ~Island()
+        {
+            delete mailbox.load();
+            delete spareMigrant.load();
+        }
+    };
+
+    struct Migrations
+    {
+        // Running islands plus full mailboxes. The search finishes when it reaches zero,
+        // since no island can be improved by a migration anymore:
+        std::atomic<std::size_t> tokens;
+
+        std::atomic<std::size_t> waitingIslands;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        explicit Migrations(std::size_t islandsCount) :
+            tokens(islandsCount),
+            waitingIslands(0)
+        {
+        }
+    };
+
+    VNS _vns;
+    int _migrationIterations;
+
+    void _run(Island& island, Island& nextIsland, Migrations& migrations)
+    {
+        VNS& vns = island.vns;
+        typename VNS::State& state = island.state;
+        std::unique_ptr<Migrant> spareMigrant;
+        bool sent = false;
+        LossType sentLoss = state.loss;
+
+        while(true)
+        {
+            bool finished = vns.iterate(state, _migrationIterations);
+
+            // Send the best solution to the next island if it has been improved:
+
+            if(! sent || state.loss < sentLoss)
+            {
+                _send(state, nextIsland, spareMigrant, migrations);
+                sent = true;
+                sentLoss = state.loss;
+            }
+
+            // This island holds its own token, so releasing the mailbox one never finishes the search:
+
+            Migrant* migrant = island.mailbox.exchange(nullptr);
+
+            if(migrant)
+            {
+                bool improved = _receive(island, migrant);
+                migrations.tokens.fetch_sub(1);
+
+                if(improved)
+                {
+                    continue;
+                }
+            }
+
+            if(! finished)
+            {
+                continue;
+            }
+
+            // Wait for migrants while other islands are running or migrants are undelivered.
+            // A received migrant which improves this island takes over its mailbox token:
+
+            bool improved = false;
+
+            while(! improved)
+            {
+                if(migrations.tokens.fetch_sub(1) == 1)
+                {
+                    _notify(migrations);
+                    return;
+                }
+
+                _wait(island, migrations);
+                migrant = island.mailbox.exchange(nullptr);
+
+                if(! migrant)
+                {
+                    return;
+                }
+
+                improved = _receive(island, migrant);
+            }
+        }
+    }
+
+    static void _send(const typename VNS::State& state, Island& nextIsland, std::unique_ptr<Migrant>& spareMigrant,
+                      Migrations& migrations)
+    {
+        // Migrants not received by the next island or already received by it are reused:
+
+        Migrant* migrant = spareMigrant ? spareMigrant.release() : nextIsland.spareMigrant.exchange(nullptr);
+
+        if(migrant)
+        {
+            migrant->solution = state.solution;
+            migrant->loss = state.loss;
+        }
+        else
+        {
+            migrant = new Migrant{ state.solution, state.loss };
+        }
+
+        migrations.tokens.fetch_add(1);
+        spareMigrant.reset(nextIsland.mailbox.exchange(migrant));
+
+        if(spareMigrant)
+        {
+            // The replaced migrant was holding a token, but this island holds its own, so it can't reach zero:
+
+            migrations.tokens.fetch_sub(1);
+        }
+
+        _notify(migrations);
+    }
+
+    static bool _receive(Island& island, Migrant* migrant)
+    {
+        // Replace the best solution with the received one if it is better,
+        // swapping solutions so the migrant storage can be reused:
+
+        bool improved = migrant->loss < island.state.loss;
+
+        if(improved)
+        {
+            std::swap(migrant->solution, island.state.solution);
+            island.state = island.vns.createState(std::move(island.state.solution), migrant->loss);
+            island.state.optimized = true;
+        }
+
+        delete island.spareMigrant.exchange(migrant);
+        return improved;
+    }
+
+    static void _wait(Island& island, Migrations& migrations)
+    {
+        std::unique_lock<std::mutex> lock(migrations.mutex);
+        migrations.waitingIslands.fetch_add(1);
+
+        migrations.condition.wait(lock, [&island, &migrations]
+        {
+            return island.mailbox.load() || ! migrations.tokens.load();
+        });
+
+        migrations.waitingIslands.fetch_sub(1);
+    }
+
+    static void _notify(Migrations& migrations)
+    {
+        // Mailboxes and tokens are updated before checking for waiting islands, and waiting islands are counted
+        // before checking mailboxes and tokens, so at least one side sees the other:
+
+        if(migrations.waitingIslands.load())
+        {
+            std::lock_guard<std::mutex> lock(migrations.mutex);
+            migrations.condition.notify_all();
+        }
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
@@ -19,8 +19,9 @@
 #ifndef HIKE_LOCAL_SEARCH_BASE_H
 #define HIKE_LOCAL_SEARCH_BASE_H
 
+#include <cstdint>
 #include <utility>
-#include "hike_common.h"
+#include "hike_loss_function_traits.h"
 
 namespace hike
 {
@@ -69,6 +70,23 @@ public:
         _neighborhood = neighborhood;
     }
 
+    /**
+     * @brief Returns the number of candidate solutions evaluated since the construction of this object
+     * or the last call to resetEvaluationsCount.
+     */
+    std::uint64_t getEvaluationsCount() const noexcept
+    {
+        return _evaluationsCount;
+    }
+
+    /**
+     * @brief Sets the number of evaluated candidate solutions to zero.
+     */
+    void resetEvaluationsCount() noexcept
+    {
+        _evaluationsCount = 0;
+    }
+
     /**
      * @brief Returns the callback called when a given solution is improved.
      */
@@ -91,15 +109,132 @@ protected:
     LossFunction _lossFunction;
     OnImprovedSolution _onImprovedSolution;
     int _neighborhood;
+    std::uint64_t _evaluationsCount;
+    const void* _hashedSolution;
+    std::size_t _solutionHash;
 
     template<class LossFunctionType, class OnImprovedSolutionType>
     LocalSearchBase(LossFunctionType&& lossFunction, OnImprovedSolutionType&& onImprovedSolution, int neighborhood) :
         _lossFunction(std::forward<LossFunctionType>(lossFunction)),
-        _onImprovedSolution(std::forward<OnImprovedSolutionType>(onImprovedSolution))
+        _onImprovedSolution(std::forward<OnImprovedSolutionType>(onImprovedSolution)),
+        _evaluationsCount(0),
+        _hashedSolution(nullptr),
+        _solutionHash(0)
     {
         setNeighborhood(neighborhood);
     }
 
+    template<typename Param>
+    static bool _isFrozen(const Param& stepParam)
+    {
+        // Parameters with a zero step are never changed:
+        return stepParam == Param();
+    }
+
+    template<class Solution>
+    void _startHashing(const Solution& solution)
+    {
+        _startHashing(solution, std::integral_constant<bool, HasHashedLoss<LossFunction, Solution>::value>());
+    }
+
+    template<class Solution>
+    void _startHashing(const Solution& solution, std::true_type)
+    {
+        // The given solution is hashed once, and its hash is updated when its parameters are changed with _setParam:
+
+        _hashedSolution = &solution;
+        _solutionHash = ZobristHash<Solution>()(solution);
+    }
+
+    template<class Solution>
+    void _startHashing(const Solution&, std::false_type)
+    {
+    }
+
+    void _stopHashing() noexcept
+    {
+        _hashedSolution = nullptr;
+    }
+
+    template<class Solution, typename Param>
+    void _setParam(Solution& solution, std::size_t paramIndex, const Param& param)
+    {
+        _setParam(solution, paramIndex, param,
+                  std::integral_constant<bool, HasHashedLoss<LossFunction, Solution>::value>());
+    }
+
+    template<class Solution, typename Param>
+    void _setParam(Solution& solution, std::size_t paramIndex, const Param& param, std::true_type)
+    {
+        if(&solution == _hashedSolution)
+        {
+            auto oldParam = solution[paramIndex];
+            solution[paramIndex] = param;
+            _solutionHash = ZobristHash<Solution>::update(_solutionHash, paramIndex, oldParam, solution[paramIndex]);
+        }
+        else
+        {
+            solution[paramIndex] = param;
+        }
+    }
+
+    template<class Solution, typename Param>
+    void _setParam(Solution& solution, std::size_t paramIndex, const Param& param, std::false_type)
+    {
+        solution[paramIndex] = param;
+    }
+
+    template<class Solution, typename LossType>
+    LossType _evaluate(const Solution& solution, const LossType& cutoff)
+    {
+        ++_evaluationsCount;
+        return _evaluate(solution, cutoff,
+                         std::integral_constant<bool, HasHashedLoss<LossFunction, Solution>::value>());
+    }
+
+    template<class Solution, typename LossType>
+    LossType _evaluate(const Solution& solution, const LossType& cutoff, std::true_type)
+    {
+        if(&solution == _hashedSolution)
+        {
+            return _lossFunction.hashedLoss(HashedSolution<Solution>{ solution, _solutionHash }, cutoff);
+        }
+
+        return evaluateLoss(_lossFunction, solution, cutoff);
+    }
+
+    template<class Solution, typename LossType>
+    LossType _evaluate(const Solution& solution, const LossType& cutoff, std::false_type)
+    {
+        return evaluateLoss(_lossFunction, solution, cutoff);
+    }
+
+    template<class Solution, typename LossType>
+    bool _skipNextParams(const Solution& solution, std::size_t paramIndex, const LossType& bestLoss)
+    {
+        if(paramIndex + 1 >= solution.size())
+        {
+            return false;
+        }
+
+        return _skipNextParams(solution, paramIndex, bestLoss,
+                               std::integral_constant<bool, HasLowerBound<LossFunction, Solution>::value>());
+    }
+
+    template<class Solution, typename LossType>
+    bool _skipNextParams(const Solution& solution, std::size_t paramIndex, const LossType& bestLoss,
+                         std::true_type)
+    {
+        // Candidate solutions which only change the next parameters can't improve the best loss:
+        return ! (_lossFunction.lowerBound(solution, paramIndex) < bestLoss);
+    }
+
+    template<class Solution, typename LossType>
+    bool _skipNextParams(const Solution&, std::size_t, const LossType&, std::false_type)
+    {
+        return false;
+    }
+
     ///@endcond
 };
 
@@ -0,0 +1,325 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_LOSS_FUNCTION_TRAITS_H
+#define HIKE_LOSS_FUNCTION_TRAITS_H
+
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include "hike_solution_move.h"
+#include "hike_zobrist_hash.h"
+
+namespace hike
+{
+
+/**
+ * @brief Indicates if the given loss function provides lower bounds for partially fixed solutions.
+ *
+ * A loss function provides lower bounds if it has a method with this signature:
+ *
+ * @code
+ * LossType lowerBound(const Solution& solution, std::size_t paramIndex);
+ * @endcode
+ *
+ * The returned value must not be greater than the loss of any solution
+ * whose parameters in the range [0, paramIndex] are equal to the given solution ones.
+ */
+template<class LossFunction, class Solution>
+class HasLowerBound
+{
+
+protected:
+    ///@cond INTERNAL
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(std::declval<LossFunctionType&>().lowerBound(
+                                           std::declval<const Solution&>(), std::size_t()), std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function provides lower bounds, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+/**
+ * @brief Indicates if the given loss function can stop calculating a loss when it exceeds a cutoff value.
+ *
+ * A loss function supports cutoff values if it has a method with this signature:
+ *
+ * @code
+ * LossType operator()(const Solution& solution, const LossType& cutoff);
+ * @endcode
+ *
+ * If the loss of the given solution is lower than the cutoff value, the exact loss must be returned.
+ * Otherwise, any value not lower than the cutoff value can be returned.
+ */
+template<class LossFunction, class Solution>
+class HasCutoff
+{
+
+protected:
+    ///@cond INTERNAL
+
+    using _LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(std::declval<LossFunctionType&>()(
+                                           std::declval<const Solution&>(), std::declval<const _LossType&>()),
+                                       std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function supports cutoff values, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+/**
+ * @brief Indicates if the given loss function provides cheap approximations of its losses (surrogate losses).
+ *
+ * A loss function provides surrogate losses if it has a method with this signature:
+ *
+ * @code
+ * SurrogateLossType surrogate(const Solution& solution);
+ * @endcode
+ *
+ * Lower surrogate losses should correspond to lower losses, but they don't need to be equal.
+ */
+template<class LossFunction, class Solution>
+class HasSurrogate
+{
+
+protected:
+    ///@cond INTERNAL
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(std::declval<LossFunctionType&>().surrogate(std::declval<const Solution&>()),
+                                       std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function provides surrogate losses, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+/**
+ * @brief Indicates if the given loss function can calculate losses of candidate solutions
+ * represented as a base solution plus the parameters which differ from it (see SolutionMove).
+ *
+ * A loss function supports solution moves if it has a method with this signature:
+ *
+ * @code
+ * LossType operator()(const SolutionMove<Solution>& move);
+ * @endcode
+ *
+ * It can also support cutoff values for solution moves (see HasCutoff).
+ */
+template<class LossFunction, class Solution>
+class HasMoveLoss
+{
+
+protected:
+    ///@cond INTERNAL
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(std::declval<LossFunctionType&>()(
+                                           std::declval<const SolutionMove<Solution>&>()), std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function supports solution moves, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+/**
+ * @brief Indicates if the given loss function can calculate losses of solutions whose hash is already known
+ * (see HashedSolution).
+ *
+ * A loss function supports hashed solutions if it has a method with this signature:
+ *
+ * @code
+ * LossType hashedLoss(const HashedSolution<Solution>& hashedSolution, const LossType& cutoff);
+ * @endcode
+ *
+ * Cutoff values must be handled as in loss functions which support them (see HasCutoff).
+ * Local searches keep the hash of the candidate solution updated as they change its parameters,
+ * so it is cheaper than hashing the whole solution for each candidate.
+ *
+ * Local searches only hash solutions for loss functions which support hashed solutions,
+ * so caches provide it only if they identify solutions with ZobristHash.
+ */
+template<class LossFunction, class Solution>
+class HasHashedLoss
+{
+
+protected:
+    ///@cond INTERNAL
+
+    using _LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(std::declval<LossFunctionType&>().hashedLoss(
+                                           std::declval<const HashedSolution<Solution>&>(),
+                                           std::declval<const _LossType&>()), std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function supports hashed solutions, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+/**
+ * @brief Indicates if the given loss function provides a custom clone method.
+ *
+ * A loss function provides a custom clone method if it has a method with this signature:
+ *
+ * @code
+ * LossFunction clone() const;
+ * @endcode
+ *
+ * The returned loss function must calculate the same losses as the original one,
+ * but it must not share mutable state (like scratch buffers) with it.
+ */
+template<class LossFunction>
+class HasClone
+{
+
+protected:
+    ///@cond INTERNAL
+
+    template<class LossFunctionType>
+    static auto _test(int) -> decltype(LossFunctionType(std::declval<const LossFunctionType&>().clone()),
+                                       std::true_type());
+
+    template<class LossFunctionType>
+    static std::false_type _test(...);
+
+    ///@endcond
+
+public:
+    /**
+     * @brief true if the given loss function provides a custom clone method, otherwise false.
+     */
+    static constexpr bool value = decltype(_test<LossFunction>(0))::value;
+};
+
+///@cond INTERNAL
+
+template<class LossFunction, class Solution, bool hasSurrogate = HasSurrogate<LossFunction, Solution>::value>
+struct _SurrogateLossType
+{
+    using type = typename std::result_of<LossFunction(const Solution&)>::type;
+};
+
+template<class LossFunction, class Solution>
+struct _SurrogateLossType<LossFunction, Solution, true>
+{
+    using type = typename std::decay<decltype(std::declval<LossFunction&>().surrogate(
+                                                  std::declval<const Solution&>()))>::type;
+};
+
+///@endcond
+
+/**
+ * @brief Surrogate loss type of the given loss function, or its loss type if it doesn't provide surrogate losses.
+ */
+template<class LossFunction, class Solution>
+using SurrogateLossType = typename _SurrogateLossType<LossFunction, Solution>::type;
+
+///@cond INTERNAL
+
+template<class LossFunction, class Solution, typename LossType>
+LossType _evaluateLoss(LossFunction& lossFunction, const Solution& solution, const LossType& cutoff, std::true_type)
+{
+    return lossFunction(solution, cutoff);
+}
+
+template<class LossFunction, class Solution, typename LossType>
+LossType _evaluateLoss(LossFunction& lossFunction, const Solution& solution, const LossType&, std::false_type)
+{
+    return lossFunction(solution);
+}
+
+template<class LossFunction>
+LossFunction _cloneLossFunction(const LossFunction& lossFunction, std::true_type)
+{
+    return lossFunction.clone();
+}
+
+template<class LossFunction>
+LossFunction _cloneLossFunction(const LossFunction& lossFunction, std::false_type)
+{
+    return lossFunction;
+}
+
+///@endcond
+
+/**
+ * @brief Returns a copy of the given loss function, created with its clone method if it provides one (see HasClone).
+ */
+template<class LossFunction>
+LossFunction cloneLossFunction(const LossFunction& lossFunction)
+{
+    return _cloneLossFunction(lossFunction, std::integral_constant<bool, HasClone<LossFunction>::value>());
+}
+
+/**
+ * @brief Returns the loss of the given solution, stopping its calculation when it exceeds the given cutoff value
+ * if the loss function supports it (see HasCutoff).
+ */
+template<class LossFunction, class Solution, typename LossType>
+LossType evaluateLoss(LossFunction& lossFunction, const Solution& solution, const LossType& cutoff)
+{
+    return _evaluateLoss(lossFunction, solution, cutoff,
+                         std::integral_constant<bool, HasCutoff<LossFunction, Solution>::value>());
+}
+
+}
+
+#endif
@@ -0,0 +1,977 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_LOSS_KERNELS_H
+#define HIKE_LOSS_KERNELS_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include "hike_common.h"
+
+// SIMD instruction sets, selected at compile time (define HIKE_NO_SIMD to use scalar kernels only):
+#if ! defined(HIKE_NO_SIMD)
+    #if defined(__AVX2__)
+        #define HIKE_SIMD_AVX2
+        #include <immintrin.h>
+    #endif
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define HIKE_SIMD_SSE2
+        #include <emmintrin.h>
+    #endif
+#endif
+
+namespace hike
+{
+
+///@cond INTERNAL
+
+template<class Type>
+struct _ScalarSimd
+{
+    using Value = Type;
+    using Vector = Type;
+
+    static constexpr std::size_t lanes = 1;
+
+    static Vector zero() { return Vector(0); }
+    static Vector set1(Value value) { return value; }
+    static Vector load(const Value* values) { return *values; }
+    static Vector gather(const Value* const* values, std::size_t index) { return values[0][index]; }
+    static void store(Value* values, Vector vector) { *values = vector; }
+    static Vector add(Vector a, Vector b) { return a + b; }
+    static Vector sub(Vector a, Vector b) { return a - b; }
+    static Vector mul(Vector a, Vector b) { return a * b; }
+    static Vector max(Vector a, Vector b) { return a < b ? b : a; }
+    static Vector abs(Vector a) { return a < Vector(0) ? -a : a; }
+    static Value sum(Vector vector) { return vector; }
+};
+
+#if defined(HIKE_SIMD_SSE2)
+
+struct _SSE2FloatSimd
+{
+    using Value = float;
+    using Vector = __m128;
+
+    static constexpr std::size_t lanes = 4;
+
+    static Vector zero() { return _mm_setzero_ps(); }
+    static Vector set1(Value value) { return _mm_set1_ps(value); }
+    static Vector load(const Value* values) { return _mm_loadu_ps(values); }
+    static void store(Value* values, Vector vector) { _mm_storeu_ps(values, vector); }
+    static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+    static Vector abs(Vector a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+
+    static Vector gather(const Value* const* values, std::size_t index)
+    {
+        return _mm_set_ps(values[3][index], values[2][index], values[1][index], values[0][index]);
+    }
+
+    static Value sum(Vector vector)
+    {
+        Value values[lanes];
+        store(values, vector);
+        return (values[0] + values[1]) + (values[2] + values[3]);
+    }
+};
+
+struct _SSE2DoubleSimd
+{
+    using Value = double;
+    using Vector = __m128d;
+
+    static constexpr std::size_t lanes = 2;
+
+    static Vector zero() { return _mm_setzero_pd(); }
+    static Vector set1(Value value) { return _mm_set1_pd(value); }
+    static Vector load(const Value* values) { return _mm_loadu_pd(values); }
+    static void store(Value* values, Vector vector) { _mm_storeu_pd(values, vector); }
+    static Vector add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm_max_pd(a, b); }
+    static Vector abs(Vector a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+
+    static Vector gather(const Value* const* values, std::size_t index)
+    {
+        return _mm_set_pd(values[1][index], values[0][index]);
+    }
+
+    static Value sum(Vector vector)
+    {
+        Value values[lanes];
+        store(values, vector);
+        return values[0] + values[1];
+    }
+};
+
+#endif
+
+#if defined(HIKE_SIMD_AVX2)
+
+struct _AVX2FloatSimd
+{
+    using Value = float;
+    using Vector = __m256;
+
+    static constexpr std::size_t lanes = 8;
+
+    static Vector zero() { return _mm256_setzero_ps(); }
+    static Vector set1(Value value) { return _mm256_set1_ps(value); }
+    static Vector load(const Value* values) { return _mm256_loadu_ps(values); }
+    static void store(Value* values, Vector vector) { _mm256_storeu_ps(values, vector); }
+    static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    static Vector abs(Vector a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+
+    static Vector gather(const Value* const* values, std::size_t index)
+    {
+        return _mm256_set_ps(values[7][index], values[6][index], values[5][index], values[4][index],
+                             values[3][index], values[2][index], values[1][index], values[0][index]);
+    }
+
+    static Value sum(Vector vector)
+    {
+        return _SSE2FloatSimd::sum(_mm_add_ps(_mm256_castps256_ps128(vector), _mm256_extractf128_ps(vector, 1)));
+    }
+};
+
+struct _AVX2DoubleSimd
+{
+    using Value = double;
+    using Vector = __m256d;
+
+    static constexpr std::size_t lanes = 4;
+
+    static Vector zero() { return _mm256_setzero_pd(); }
+    static Vector set1(Value value) { return _mm256_set1_pd(value); }
+    static Vector load(const Value* values) { return _mm256_loadu_pd(values); }
+    static void store(Value* values, Vector vector) { _mm256_storeu_pd(values, vector); }
+    static Vector add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+    static Vector max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+    static Vector abs(Vector a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+
+    static Vector gather(const Value* const* values, std::size_t index)
+    {
+        return _mm256_set_pd(values[3][index], values[2][index], values[1][index], values[0][index]);
+    }
+
+    static Value sum(Vector vector)
+    {
+        return _SSE2DoubleSimd::sum(_mm_add_pd(_mm256_castpd256_pd128(vector), _mm256_extractf128_pd(vector, 1)));
+    }
+};
+
+#endif
+
+template<class Value>
+struct _BestSimd
+{
+    using Type = _ScalarSimd<Value>;
+};
+
+#if defined(HIKE_SIMD_AVX2)
+
+template<>
+struct _BestSimd<float>
+{
+    using Type = _AVX2FloatSimd;
+};
+
+template<>
+struct _BestSimd<double>
+{
+    using Type = _AVX2DoubleSimd;
+};
+
+#elif defined(HIKE_SIMD_SSE2)
+
+template<>
+struct _BestSimd<float>
+{
+    using Type = _SSE2FloatSimd;
+};
+
+template<>
+struct _BestSimd<double>
+{
+    using Type = _SSE2DoubleSimd;
+};
+
+#endif
+
+///@endcond
+
+/**
+ * @brief Loss calculation kernels for arrays of parameters, implemented with the given SIMD operations.
+ *
+ * Single solution kernels vectorize across parameters, and batch kernels vectorize across candidate solutions,
+ * so they are fast with few parameters too.
+ *
+ * Results can differ from the scalar kernels (see ScalarLossKernels) by floating point rounding,
+ * since additions are done in a different order.
+ */
+template<class Simd>
+class SimdLossKernels
+{
+
+public:
+    /**
+     * Parameter and loss type.
+     */
+    using Value = typename Simd::Value;
+
+    /**
+     * @brief Returns the weighted L1 distance between the given parameters and the target ones:
+     * sum(weights[i] * |params[i] - targetParams[i]|).
+     */
+    static Value weightedL1(const Value* params, const Value* targetParams, const Value* weights,
+                            std::size_t paramsCount)
+    {
+        using Scalar = _ScalarSimd<Value>;
+
+        typename Simd::Vector loss = Simd::zero();
+        std::size_t index = 0;
+
+        for(; index + Simd::lanes <= paramsCount; index += Simd::lanes)
+        {
+            auto distance = Simd::abs(Simd::sub(Simd::load(params + index), Simd::load(targetParams + index)));
+            loss = Simd::add(loss, Simd::mul(Simd::load(weights + index), distance));
+        }
+
+        Value result = Simd::sum(loss);
+
+        for(; index < paramsCount; ++index)
+        {
+            result += weights[index] * Scalar::abs(params[index] - targetParams[index]);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Calculates the weighted L1 distance (see weightedL1) of multiple solutions.
+     * @param solutions Parameters of each solution.
+     * @param solutionsCount Number of solutions.
+     * @param targetParams Target parameters.
+     * @param weights Parameter weights.
+     * @param paramsCount Number of parameters of each solution.
+     * @param losses Output array which receives the loss of each solution.
+     */
+    static void weightedL1(const Value* const* solutions, std::size_t solutionsCount, const Value* targetParams,
+                           const Value* weights, std::size_t paramsCount, Value* losses)
+    {
+        std::size_t solutionIndex = 0;
+
+        for(; solutionIndex + Simd::lanes <= solutionsCount; solutionIndex += Simd::lanes)
+        {
+            typename Simd::Vector loss = Simd::zero();
+
+            for(std::size_t index = 0; index < paramsCount; ++index)
+            {
+                auto distance = Simd::abs(Simd::sub(Simd::gather(solutions + solutionIndex, index),
+                                                    Simd::set1(targetParams[index])));
+                loss = Simd::add(loss, Simd::mul(Simd::set1(weights[index]), distance));
+            }
+
+            Simd::store(losses + solutionIndex, loss);
+        }
+
+        for(; solutionIndex < solutionsCount; ++solutionIndex)
+        {
+            losses[solutionIndex] = weightedL1(solutions[solutionIndex], targetParams, weights, paramsCount);
+        }
+    }
+
+    /**
+     * @brief Returns the weighted squared L2 distance between the given parameters and the target ones:
+     * sum(weights[i] * (params[i] - targetParams[i])^2).
+     */
+    static Value weightedL2(const Value* params, const Value* targetParams, const Value* weights,
+                            std::size_t paramsCount)
+    {
+        typename Simd::Vector loss = Simd::zero();
+        std::size_t index = 0;
+
+        for(; index + Simd::lanes <= paramsCount; index += Simd::lanes)
+        {
+            auto distance = Simd::sub(Simd::load(params + index), Simd::load(targetParams + index));
+            loss = Simd::add(loss, Simd::mul(Simd::load(weights + index), Simd::mul(distance, distance)));
+        }
+
+        Value result = Simd::sum(loss);
+
+        for(; index < paramsCount; ++index)
+        {
+            Value distance = params[index] - targetParams[index];
+            result += weights[index] * (distance * distance);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Calculates the weighted squared L2 distance (see weightedL2) of multiple solutions.
+     * @param solutions Parameters of each solution.
+     * @param solutionsCount Number of solutions.
+     * @param targetParams Target parameters.
+     * @param weights Parameter weights.
+     * @param paramsCount Number of parameters of each solution.
+     * @param losses Output array which receives the loss of each solution.
+     */
+    static void weightedL2(const Value* const* solutions, std::size_t solutionsCount, const Value* targetParams,
+                           const Value* weights, std::size_t paramsCount, Value* losses)
+    {
+        std::size_t solutionIndex = 0;
+
+        for(; solutionIndex + Simd::lanes <= solutionsCount; solutionIndex += Simd::lanes)
+        {
+            typename Simd::Vector loss = Simd::zero();
+
+            for(std::size_t index = 0; index < paramsCount; ++index)
+            {
+                auto distance = Simd::sub(Simd::gather(solutions + solutionIndex, index),
+                                          Simd::set1(targetParams[index]));
+                loss = Simd::add(loss, Simd::mul(Simd::set1(weights[index]), Simd::mul(distance, distance)));
+            }
+
+            Simd::store(losses + solutionIndex, loss);
+        }
+
+        for(; solutionIndex < solutionsCount; ++solutionIndex)
+        {
+            losses[solutionIndex] = weightedL2(solutions[solutionIndex], targetParams, weights, paramsCount);
+        }
+    }
+
+    /**
+     * @brief Returns the quadratic form of the given parameters plus a linear term:
+     * sum(params[i] * matrix[i * paramsCount + j] * params[j]) + sum(linearTerms[i] * params[i]).
+     * @param params Parameters.
+     * @param matrix Square matrix in row-major order.
+     * @param linearTerms Coefficients of the linear term.
+     * @param paramsCount Number of parameters.
+     */
+    static Value quadraticForm(const Value* params, const Value* matrix, const Value* linearTerms,
+                               std::size_t paramsCount)
+    {
+        Value result = 0;
+
+        for(std::size_t row = 0; row < paramsCount; ++row)
+        {
+            // The linear term is added to each matrix row product, so it is calculated in the same pass:
+
+            const Value* matrixRow = matrix + row * paramsCount;
+            typename Simd::Vector rowProduct = Simd::zero();
+            std::size_t index = 0;
+
+            for(; index + Simd::lanes <= paramsCount; index += Simd::lanes)
+            {
+                rowProduct = Simd::add(rowProduct, Simd::mul(Simd::load(matrixRow + index),
+                                                             Simd::load(params + index)));
+            }
+
+            Value rowResult = Simd::sum(rowProduct);
+
+            for(; index < paramsCount; ++index)
+            {
+                rowResult += matrixRow[index] * params[index];
+            }
+
+            result += params[row] * (rowResult + linearTerms[row]);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Calculates the quadratic form (see quadraticForm) of multiple solutions.
+     * @param solutions Parameters of each solution.
+     * @param solutionsCount Number of solutions.
+     * @param matrix Square matrix in row-major order.
+     * @param linearTerms Coefficients of the linear term.
+     * @param paramsCount Number of parameters of each solution.
+     * @param losses Output array which receives the loss of each solution.
+     */
+    static void quadraticForm(const Value* const* solutions, std::size_t solutionsCount, const Value* matrix,
+                              const Value* linearTerms, std::size_t paramsCount, Value* losses)
+    {
+        std::size_t solutionIndex = 0;
+
+        for(; solutionIndex + Simd::lanes <= solutionsCount; solutionIndex += Simd::lanes)
+        {
+            typename Simd::Vector loss = Simd::zero();
+
+            for(std::size_t row = 0; row < paramsCount; ++row)
+            {
+                const Value* matrixRow = matrix + row * paramsCount;
+                typename Simd::Vector rowProduct = Simd::set1(linearTerms[row]);
+
+                for(std::size_t index = 0; index < paramsCount; ++index)
+                {
+                    rowProduct = Simd::add(rowProduct, Simd::mul(Simd::set1(matrixRow[index]),
+                                                                 Simd::gather(solutions + solutionIndex, index)));
+                }
+
+                loss = Simd::add(loss, Simd::mul(Simd::gather(solutions + solutionIndex, row), rowProduct));
+            }
+
+            Simd::store(losses + solutionIndex, loss);
+        }
+
+        for(; solutionIndex < solutionsCount; ++solutionIndex)
+        {
+            losses[solutionIndex] = quadraticForm(solutions[solutionIndex], matrix, linearTerms, paramsCount);
+        }
+    }
+
+    /**
+     * @brief Returns the piecewise-linear penalty of the given parameters outside the given bounds:
+     * sum(lowerSlopes[i] * max(lowerBounds[i] - params[i], 0) + upperSlopes[i] * max(params[i] - upperBounds[i], 0)).
+     */
+    static Value piecewiseLinear(const Value* params, const Value* lowerBounds, const Value* upperBounds,
+                                 const Value* lowerSlopes, const Value* upperSlopes, std::size_t paramsCount)
+    {
+        using Scalar = _ScalarSimd<Value>;
+
+        typename Simd::Vector loss = Simd::zero();
+        typename Simd::Vector zero = Simd::zero();
+        std::size_t index = 0;
+
+        for(; index + Simd::lanes <= paramsCount; index += Simd::lanes)
+        {
+            auto param = Simd::load(params + index);
+            auto lowerPenalty = Simd::max(Simd::sub(Simd::load(lowerBounds + index), param), zero);
+            auto upperPenalty = Simd::max(Simd::sub(param, Simd::load(upperBounds + index)), zero);
+            loss = Simd::add(loss, Simd::add(Simd::mul(Simd::load(lowerSlopes + index), lowerPenalty),
+                                             Simd::mul(Simd::load(upperSlopes + index), upperPenalty)));
+        }
+
+        Value result = Simd::sum(loss);
+
+        for(; index < paramsCount; ++index)
+        {
+            Value lowerPenalty = Scalar::max(lowerBounds[index] - params[index], Value(0));
+            Value upperPenalty = Scalar::max(params[index] - upperBounds[index], Value(0));
+            result += lowerSlopes[index] * lowerPenalty + upperSlopes[index] * upperPenalty;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Calculates the piecewise-linear penalty (see piecewiseLinear) of multiple solutions.
+     * @param solutions Parameters of each solution.
+     * @param solutionsCount Number of solutions.
+     * @param lowerBounds Lower bound of each parameter.
+     * @param upperBounds Upper bound of each parameter.
+     * @param lowerSlopes Penalty per unit below the lower bound of each parameter.
+     * @param upperSlopes Penalty per unit above the upper bound of each parameter.
+     * @param paramsCount Number of parameters of each solution.
+     * @param losses Output array which receives the loss of each solution.
+     */
+    static void piecewiseLinear(const Value* const* solutions, std::size_t solutionsCount, const Value* lowerBounds,
+                                const Value* upperBounds, const Value* lowerSlopes, const Value* upperSlopes,
+                                std::size_t paramsCount, Value* losses)
+    {
+        std::size_t solutionIndex = 0;
+        typename Simd::Vector zero = Simd::zero();
+
+        for(; solutionIndex + Simd::lanes <= solutionsCount; solutionIndex += Simd::lanes)
+        {
+            typename Simd::Vector loss = Simd::zero();
+
+            for(std::size_t index = 0; index < paramsCount; ++index)
+            {
+                auto param = Simd::gather(solutions + solutionIndex, index);
+                auto lowerPenalty = Simd::max(Simd::sub(Simd::set1(lowerBounds[index]), param), zero);
+                auto upperPenalty = Simd::max(Simd::sub(param, Simd::set1(upperBounds[index])), zero);
+                loss = Simd::add(loss, Simd::add(Simd::mul(Simd::set1(lowerSlopes[index]), lowerPenalty),
+                                                 Simd::mul(Simd::set1(upperSlopes[index]), upperPenalty)));
+            }
+
+            Simd::store(losses + solutionIndex, loss);
+        }
+
+        for(; solutionIndex < solutionsCount; ++solutionIndex)
+        {
+            losses[solutionIndex] = piecewiseLinear(solutions[solutionIndex], lowerBounds, upperBounds, lowerSlopes,
+                                                    upperSlopes, paramsCount);
+        }
+    }
+};
+
+/**
+ * @brief Loss calculation kernels without SIMD instructions.
+ */
+template<class Value>
+using ScalarLossKernels = SimdLossKernels<_ScalarSimd<Value>>;
+
+/**
+ * @brief Loss calculation kernels with the best SIMD instruction set available at compile time
+ * for the given parameter type (AVX2 or SSE2 for float and double, scalar code otherwise).
+ */
+template<class Value>
+using LossKernels = SimdLossKernels<typename _BestSimd<Value>::Type>;
+
+/**
+ * @brief Returns the name of the best SIMD instruction set available at compile time ("AVX2", "SSE2" or "scalar").
+ */
+inline const char* getSimdInstructionSet() noexcept
+{
+#if defined(HIKE_SIMD_AVX2)
+    return "AVX2";
+#elif defined(HIKE_SIMD_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+///@cond INTERNAL
+
+template<class Loss, class Value>
+class _BatchLoss
+{
+
+public:
+    /**
+     * @brief Calculates the losses of multiple solutions at once.
+     * @param solutionsFirst Iterator to the first solution.
+     * @param solutionsLast Iterator past the last solution.
+     * @param lossesFirst Output iterator which receives the loss of each solution.
+     */
+    template<class SolutionIterator, class LossIterator>
+    void evaluate(SolutionIterator solutionsFirst, SolutionIterator solutionsLast, LossIterator lossesFirst) const
+    {
+        // Solutions are evaluated in blocks, so no heap memory is needed:
+
+        constexpr std::size_t blockSize = 64;
+        const Value* solutions[blockSize];
+        Value losses[blockSize];
+
+        while(solutionsFirst != solutionsLast)
+        {
+            std::size_t solutionsCount = 0;
+
+            for(; solutionsCount < blockSize && solutionsFirst != solutionsLast; ++solutionsCount, ++solutionsFirst)
+            {
+                HIKE_ASSERT(solutionsFirst->size() == static_cast<const Loss&>(*this).getParamsCount());
+
+                solutions[solutionsCount] = solutionsFirst->data();
+            }
+
+            static_cast<const Loss&>(*this)._evaluateBatch(solutions, solutionsCount, losses);
+
+            for(std::size_t index = 0; index < solutionsCount; ++index, ++lossesFirst)
+            {
+                *lossesFirst = losses[index];
+            }
+        }
+    }
+};
+
+///@endcond
+
+/**
+ * @brief Weighted L1 (Manhattan) distance to a target solution.
+ *
+ * Solutions must be contiguous containers of Value parameters with data() and size() methods,
+ * as std::array and std::vector.
+ */
+template<class Value, class Kernels = LossKernels<Value>>
+class WeightedL1Loss : public _BatchLoss<WeightedL1Loss<Value, Kernels>, Value>
+{
+
+public:
+    /**
+     * @brief Class constructor with unit weights.
+     * @param targetSolution Parameters of the solution with zero loss.
+     */
+    explicit WeightedL1Loss(std::vector<Value> targetSolution) :
+        _targetSolution(std::move(targetSolution)),
+        _weights(_targetSolution.size(), Value(1))
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param targetSolution Parameters of the solution with zero loss.
+     * @param weights Weight of each parameter.
+     */
+    WeightedL1Loss(std::vector<Value> targetSolution, std::vector<Value> weights) :
+        _targetSolution(std::move(targetSolution)),
+        _weights(std::move(weights))
+    {
+        HIKE_ASSERT(_targetSolution.size() == _weights.size());
+    }
+
+    /**
+     * @brief Returns the number of parameters of each solution.
+     */
+    std::size_t getParamsCount() const noexcept
+    {
+        return _targetSolution.size();
+    }
+
+    /**
+     * @brief Returns the parameters of the solution with zero loss.
+     */
+    const std::vector<Value>& getTargetSolution() const noexcept
+    {
+        return _targetSolution;
+    }
+
+    /**
+     * @brief Returns the weight of each parameter.
+     */
+    const std::vector<Value>& getWeights() const noexcept
+    {
+        return _weights;
+    }
+
+    /**
+     * @brief Returns the loss of the given solution.
+     */
+    template<class Solution>
+    Value operator()(const Solution& solution) const
+    {
+        HIKE_ASSERT(solution.size() == getParamsCount());
+
+        return Kernels::weightedL1(solution.data(), _targetSolution.data(), _weights.data(), getParamsCount());
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BatchLoss<WeightedL1Loss, Value>;
+
+    std::vector<Value> _targetSolution;
+    std::vector<Value> _weights;
+
+    void _evaluateBatch(const Value* const* solutions, std::size_t solutionsCount, Value* losses) const
+    {
+        Kernels::weightedL1(solutions, solutionsCount, _targetSolution.data(), _weights.data(), getParamsCount(),
+                            losses);
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Weighted squared L2 (Euclidean) distance to a target solution.
+ *
+ * Solutions must be contiguous containers of Value parameters with data() and size() methods,
+ * as std::array and std::vector.
+ */
+template<class Value, class Kernels = LossKernels<Value>>
+class WeightedL2Loss : public _BatchLoss<WeightedL2Loss<Value, Kernels>, Value>
+{
+
+public:
+    /**
+     * @brief Class constructor with unit weights.
+     * @param targetSolution Parameters of the solution with zero loss.
+     */
+    explicit WeightedL2Loss(std::vector<Value> targetSolution) :
+        _targetSolution(std::move(targetSolution)),
+        _weights(_targetSolution.size(), Value(1))
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param targetSolution Parameters of the solution with zero loss.
+     * @param weights Weight of each parameter.
+     */
+    WeightedL2Loss(std::vector<Value> targetSolution, std::vector<Value> weights) :
+        _targetSolution(std::move(targetSolution)),
+        _weights(std::move(weights))
+    {
+        HIKE_ASSERT(_targetSolution.size() == _weights.size());
+    }
+
+    /**
+     * @brief Returns the number of parameters of each solution.
+     */
+    std::size_t getParamsCount() const noexcept
+    {
+        return _targetSolution.size();
+    }
+
+    /**
+     * @brief Returns the parameters of the solution with zero loss.
+     */
+    const std::vector<Value>& getTargetSolution() const noexcept
+    {
+        return _targetSolution;
+    }
+
+    /**
+     * @brief Returns the weight of each parameter.
+     */
+    const std::vector<Value>& getWeights() const noexcept
+    {
+        return _weights;
+    }
+
+    /**
+     * @brief Returns the loss of the given solution.
+     */
+    template<class Solution>
+    Value operator()(const Solution& solution) const
+    {
+        HIKE_ASSERT(solution.size() == getParamsCount());
+
+        return Kernels::weightedL2(solution.data(), _targetSolution.data(), _weights.data(), getParamsCount());
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BatchLoss<WeightedL2Loss, Value>;
+
+    std::vector<Value> _targetSolution;
+    std::vector<Value> _weights;
+
+    void _evaluateBatch(const Value* const* solutions, std::size_t solutionsCount, Value* losses) const
+    {
+        Kernels::weightedL2(solutions, solutionsCount, _targetSolution.data(), _weights.data(), getParamsCount(),
+                            losses);
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Quadratic form of the solution parameters plus a linear term: x^T * A * x + b^T * x.
+ *
+ * Solutions must be contiguous containers of Value parameters with data() and size() methods,
+ * as std::array and std::vector.
+ */
+template<class Value, class Kernels = LossKernels<Value>>
+class QuadraticFormLoss : public _BatchLoss<QuadraticFormLoss<Value, Kernels>, Value>
+{
+
+public:
+    /**
+     * @brief Class constructor without linear term.
+     * @param matrix Square matrix (A) in row-major order.
+     * @param paramsCount Number of parameters of each solution.
+     */
+    QuadraticFormLoss(std::vector<Value> matrix, std::size_t paramsCount) :
+        _matrix(std::move(matrix)),
+        _linearTerms(paramsCount, Value(0))
+    {
+        HIKE_ASSERT(_matrix.size() == paramsCount * paramsCount);
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param matrix Square matrix (A) in row-major order.
+     * @param linearTerms Coefficients of the linear term (b), one per parameter.
+     */
+    QuadraticFormLoss(std::vector<Value> matrix, std::vector<Value> linearTerms) :
+        _matrix(std::move(matrix)),
+        _linearTerms(std::move(linearTerms))
+    {
+        HIKE_ASSERT(_matrix.size() == _linearTerms.size() * _linearTerms.size());
+    }
+
+    /**
+     * @brief Returns the number of parameters of each solution.
+     */
+    std::size_t getParamsCount() const noexcept
+    {
+        return _linearTerms.size();
+    }
+
+    /**
+     * @brief Returns the square matrix (A) in row-major order.
+     */
+    const std::vector<Value>& getMatrix() const noexcept
+    {
+        return _matrix;
+    }
+
+    /**
+     * @brief Returns the coefficients of the linear term (b).
+     */
+    const std::vector<Value>& getLinearTerms() const noexcept
+    {
+        return _linearTerms;
+    }
+
+    /**
+     * @brief Returns the loss of the given solution.
+     */
+    template<class Solution>
+    Value operator()(const Solution& solution) const
+    {
+        HIKE_ASSERT(solution.size() == getParamsCount());
+
+        return Kernels::quadraticForm(solution.data(), _matrix.data(), _linearTerms.data(), getParamsCount());
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BatchLoss<QuadraticFormLoss, Value>;
+
+    std::vector<Value> _matrix;
+    std::vector<Value> _linearTerms;
+
+    void _evaluateBatch(const Value* const* solutions, std::size_t solutionsCount, Value* losses) const
+    {
+        Kernels::quadraticForm(solutions, solutionsCount, _matrix.data(), _linearTerms.data(), getParamsCount(),
+                               losses);
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Piecewise-linear penalty of the solution parameters outside the given bounds.
+ *
+ * Parameters inside their bounds have no penalty. Outside them, the penalty grows linearly
+ * with the distance to the bound.
+ *
+ * Solutions must be contiguous containers of Value parameters with data() and size() methods,
+ * as std::array and std::vector.
+ */
+template<class Value, class Kernels = LossKernels<Value>>
+class PiecewiseLinearPenaltyLoss : public _BatchLoss<PiecewiseLinearPenaltyLoss<Value, Kernels>, Value>
+{
+
+public:
+    /**
+     * @brief Class constructor with unit slopes.
+     * @param lowerBounds Lower bound of each parameter.
+     * @param upperBounds Upper bound of each parameter.
+     */
+    PiecewiseLinearPenaltyLoss(std::vector<Value> lowerBounds, std::vector<Value> upperBounds) :
+        _lowerBounds(std::move(lowerBounds)),
+        _upperBounds(std::move(upperBounds)),
+        _lowerSlopes(_lowerBounds.size(), Value(1)),
+        _upperSlopes(_lowerBounds.size(), Value(1))
+    {
+        HIKE_ASSERT(_lowerBounds.size() == _upperBounds.size());
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param lowerBounds Lower bound of each parameter.
+     * @param upperBounds Upper bound of each parameter.
+     * @param lowerSlopes Penalty per unit below the lower bound of each parameter.
+     * @param upperSlopes Penalty per unit above the upper bound of each parameter.
+     */
+    PiecewiseLinearPenaltyLoss(std::vector<Value> lowerBounds, std::vector<Value> upperBounds,
+                               std::vector<Value> lowerSlopes, std::vector<Value> upperSlopes) :
+        _lowerBounds(std::move(lowerBounds)),
+        _upperBounds(std::move(upperBounds)),
+        _lowerSlopes(std::move(lowerSlopes)),
+        _upperSlopes(std::move(upperSlopes))
+    {
+        HIKE_ASSERT(_lowerBounds.size() == _upperBounds.size());
+        HIKE_ASSERT(_lowerBounds.size() == _lowerSlopes.size());
+        HIKE_ASSERT(_lowerBounds.size() == _upperSlopes.size());
+    }
+
+    /**
+     * @brief Returns the number of parameters of each solution.
+     */
+    std::size_t getParamsCount() const noexcept
+    {
+        return _lowerBounds.size();
+    }
+
+    /**
+     * @brief Returns the lower bound of each parameter.
+     */
+    const std::vector<Value>& getLowerBounds() const noexcept
+    {
+        return _lowerBounds;
+    }
+
+    /**
+     * @brief Returns the upper bound of each parameter.
+     */
+    const std::vector<Value>& getUpperBounds() const noexcept
+    {
+        return _upperBounds;
+    }
+
+    /**
+     * @brief Returns the penalty per unit below the lower bound of each parameter.
+     */
+    const std::vector<Value>& getLowerSlopes() const noexcept
+    {
+        return _lowerSlopes;
+    }
+
+    /**
+     * @brief Returns the penalty per unit above the upper bound of each parameter.
+     */
+    const std::vector<Value>& getUpperSlopes() const noexcept
+    {
+        return _upperSlopes;
+    }
+
+    /**
+     * @brief Returns the loss of the given solution.
+     */
+    template<class Solution>
+    Value operator()(const Solution& solution) const
+    {
+        HIKE_ASSERT(solution.size() == getParamsCount());
+
+        return Kernels::piecewiseLinear(solution.data(), _lowerBounds.data(), _upperBounds.data(),
+                                        _lowerSlopes.data(), _upperSlopes.data(), getParamsCount());
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    friend class _BatchLoss<PiecewiseLinearPenaltyLoss, Value>;
+
+    std::vector<Value> _lowerBounds;
+    std::vector<Value> _upperBounds;
+    std::vector<Value> _lowerSlopes;
+    std::vector<Value> _upperSlopes;
+
+    void _evaluateBatch(const Value* const* solutions, std::size_t solutionsCount, Value* losses) const
+    {
+        Kernels::piecewiseLinear(solutions, solutionsCount, _lowerBounds.data(), _upperBounds.data(),
+                                 _lowerSlopes.data(), _upperSlopes.data(), getParamsCount(), losses);
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
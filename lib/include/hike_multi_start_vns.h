@@ -0,0 +1,308 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_MULTI_START_VNS_H
+#define HIKE_MULTI_START_VNS_H
+
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include "hike_thread_pool.h"
+
+namespace hike
+{
+
+/**
+ * @brief Runs multiple variable neighborhood searches from different initial solutions (starts) in parallel,
+ * returning the best optimized solution.
+ *
+ * Each start uses its own copy of the given VNS object (and of its local search and loss function),
+ * so it must be copyable. To share calculated losses between starts, a TSCachedLossFunction can be used,
+ * since its copies share the same cache.
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ */
+template<class Solution, class VNS>
+class MultiStartVNS
+{
+
+public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename VNS::LossType;
+
+    /**
+     * @brief Optimization result of a start.
+     */
+    struct Result
+    {
+        /**
+         * @brief Best solution found.
+         */
+        Solution solution;
+
+        /**
+         * @brief Loss of the best solution found.
+         */
+        LossType loss;
+
+        /**
+         * @brief Indicates if the initial solution has been optimized or not.
+         */
+        bool optimized;
+
+        /**
+         * @brief Indicates if the start has been cancelled because it was dominated by other ones.
+         */
+        bool cancelled;
+    };
+
+    /**
+     * @brief Class constructor which uses the number of concurrent threads supported by the implementation.
+     * @param vns VNS object copied by each start.
+     */
+    template<class VNSType>
+    explicit MultiStartVNS(VNSType&& vns) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<StartTask>()),
+        _dominatedIterations(0)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param vns VNS object copied by each start.
+     * @param threads Number of threads used to run the starts.
+     */
+    template<class VNSType>
+    MultiStartVNS(VNSType&& vns, unsigned int threads) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<StartTask>(threads)),
+        _dominatedIterations(0)
+    {
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each start.
+     */
+    const VNS& getVNS() const noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the VNS object copied by each start.
+     */
+    VNS& getVNS() noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::getSpinCount).
+     */
+    int getSpinCount() const noexcept
+    {
+        return _threadPool->getSpinCount();
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::setSpinCount).
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        _threadPool->setSpinCount(spinCount);
+    }
+
+    /**
+     * @brief Indicates if the calling thread runs pending starts too instead of waiting for the managed threads
+     * (see ThreadPool::isCallerParticipationEnabled).
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _threadPool->isCallerParticipationEnabled();
+    }
+
+    /**
+     * @brief Specifies if the calling thread runs pending starts too instead of waiting for the managed threads
+     * (disabled by default, see ThreadPool::setCallerParticipationEnabled).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _threadPool->setCallerParticipationEnabled(enabled);
+    }
+
+    /**
+     * @brief Returns the number of local searches after which a start is cancelled
+     * if its loss is not lower than the loss of an already finished start.
+     *
+     * Dominated starts are checked every time this number of local searches is applied.
+     * Zero means that starts are never cancelled.
+     */
+    int getDominatedIterations() const noexcept
+    {
+        return _dominatedIterations;
+    }
+
+    /**
+     * @brief Specifies the number of local searches after which a start is cancelled
+     * if its loss is not lower than the loss of an already finished start.
+     *
+     * Dominated starts are checked every time this number of local searches is applied.
+     * Zero means that starts are never cancelled.
+     */
+    void setDominatedIterations(int dominatedIterations)
+    {
+        HIKE_ASSERT(dominatedIterations >= 0);
+
+        _dominatedIterations = dominatedIterations;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solutions.
+     * @param solutions Initial solutions, one per start.
+     * @return The best optimized solution.
+     */
+    Solution optimize(const std::vector<Solution>& solutions)
+    {
+        std::vector<Result> results;
+
+        return optimize(solutions, results);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solutions.
+     * @param solutions Initial solutions, one per start.
+     * @param results Output parameter which contains the optimization result of each start.
+     * @return The best optimized solution.
+     */
+    Solution optimize(const std::vector<Solution>& solutions, std::vector<Result>& results)
+    {
+        HIKE_ASSERT(! solutions.empty());
+
+        std::size_t startsCount = solutions.size();
+        results.clear();
+        results.reserve(startsCount);
+
+        for(const Solution& solution : solutions)
+        {
+            results.push_back(Result{ solution, LossType(), false, false });
+        }
+
+        _finished = false;
+
+        for(Result& result : results)
+        {
+            _threadPool->add(StartTask(*this, result));
+        }
+
+        _threadPool->join();
+
+        const Result* bestResult = &results[0];
+
+        for(std::size_t index = 1; index < startsCount; ++index)
+        {
+            const Result& result = results[index];
+
+            if(result.loss < bestResult->loss)
+            {
+                bestResult = &result;
+            }
+        }
+
+        return bestResult->solution;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    class StartTask
+    {
+
+    public:
+        StartTask(MultiStartVNS& multiStartVNS, Result& result) :
+            _multiStartVNS(multiStartVNS),
+            _result(result)
+        {
+        }
+
+        void operator()()
+        {
+            _multiStartVNS._run(_result);
+        }
+
+    protected:
+        MultiStartVNS& _multiStartVNS;
+        Result& _result;
+    };
+
+    VNS _vns;
+    std::unique_ptr<ThreadPool<StartTask>> _threadPool;
+    int _dominatedIterations;
+
+    std::mutex _finishedMutex;
+    LossType _finishedLoss;
+    bool _finished;
+
+    void _run(Result& result)
+    {
+        VNS vns = _vns;
+        typename VNS::State state = vns.createState(std::move(result.solution));
+        int iterations = _dominatedIterations ? _dominatedIterations : std::numeric_limits<int>::max();
+
+        while(! vns.iterate(state, iterations))
+        {
+            // Cancel the start if it is dominated by a finished one:
+
+            std::lock_guard<std::mutex> lock(_finishedMutex);
+
+            if(_finished && ! (state.loss < _finishedLoss))
+            {
+                result.cancelled = true;
+                break;
+            }
+        }
+
+        if(! result.cancelled)
+        {
+            std::lock_guard<std::mutex> lock(_finishedMutex);
+
+            if(! _finished || state.loss < _finishedLoss)
+            {
+                _finishedLoss = state.loss;
+                _finished = true;
+            }
+        }
+
+        result.solution = std::move(state.solution);
+        result.loss = state.loss;
+        result.optimized = state.optimized;
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
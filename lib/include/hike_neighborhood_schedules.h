@@ -0,0 +1,315 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+
+#ifndef HIKE_NEIGHBORHOOD_SCHEDULES_H
+#define HIKE_NEIGHBORHOOD_SCHEDULES_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Result of a local search with a given neighborhood, used by neighborhood schedules to select
+ * the next neighborhood.
+ */
+struct NeighborhoodResult
+{
+    /**
+     * @brief Neighborhood of the local search.
+     */
+    int k;
+
+    /**
+     * @brief Indicates if the local search has improved the best solution.
+     */
+    bool improved;
+
+    /**
+     * @brief Loss decrease of the best solution (zero if it has not been improved,
+     * and one if the loss type is not arithmetic).
+     */
+    double improvement;
+
+    /**
+     * @brief Number of candidate solutions evaluated by the local search.
+     */
+    std::uint64_t evaluations;
+};
+
+///@cond INTERNAL
+
+template<class Schedule>
+class _StepNeighborhoodSchedule
+{
+
+public:
+    /**
+     * @brief Schedule state of an optimization process.
+     */
+    struct State
+    {
+        /**
+         * @brief Position of the current neighborhood in the schedule.
+         */
+        int step;
+    };
+
+    /**
+     * @brief Indicates if the schedule goes back to the neighborhood which precedes the improving one
+     * instead of going back to the first one when a solution is improved.
+     */
+    bool isResetToPreviousEnabled() const noexcept
+    {
+        return _resetToPreviousEnabled;
+    }
+
+    /**
+     * @brief Specifies if the schedule goes back to the neighborhood which precedes the improving one
+     * instead of going back to the first one when a solution is improved (disabled by default).
+     */
+    void setResetToPreviousEnabled(bool enabled) noexcept
+    {
+        _resetToPreviousEnabled = enabled;
+    }
+
+    /**
+     * @brief Initializes the given state and returns its first neighborhood.
+     */
+    int first(State& state, int kmax) const
+    {
+        state.step = 0;
+        return _schedule().getNeighborhood(0, kmax);
+    }
+
+    /**
+     * @brief Returns the neighborhood which follows the one of the last local search.
+     * @param state Schedule state to update.
+     * @param result Result of the last local search.
+     * @param kmax Maximum neighborhood.
+     * @return Next neighborhood, or a value greater than kmax if the optimization process has finished.
+     */
+    int next(State& state, const NeighborhoodResult& result, int kmax) const
+    {
+        if(! result.improved)
+        {
+            ++state.step;
+        }
+        else if(_resetToPreviousEnabled)
+        {
+            if(state.step > 0)
+            {
+                --state.step;
+            }
+        }
+        else
+        {
+            state.step = 0;
+        }
+
+        return _schedule().getNeighborhood(state.step, kmax);
+    }
+
+protected:
+    bool _resetToPreviousEnabled;
+
+    _StepNeighborhoodSchedule() :
+        _resetToPreviousEnabled(false)
+    {
+    }
+
+    const Schedule& _schedule() const noexcept
+    {
+        return static_cast<const Schedule&>(*this);
+    }
+};
+
+///@endcond
+
+/**
+ * @brief Walks the neighborhoods 1, 2, ..., kmax, restarting from the first one when a solution is improved.
+ *
+ * A neighborhood schedule controls the sequence of neighborhoods passed to the local search by VNS.
+ *
+ * All schedules provide a State type and the following methods:
+ * - int first(State& state, int kmax): initializes the given state and returns its first neighborhood.
+ * - int next(State& state, const NeighborhoodResult& result, int kmax): returns the neighborhood which follows
+ * the one of the last local search.
+ *
+ * The optimization process finishes when the returned neighborhood is greater than kmax.
+ *
+ * If reset to previous is enabled, after an improvement the schedule goes back to the neighborhood
+ * which precedes the improving one instead of going back to the first one.
+ */
+class LinearNeighborhoodSchedule : public _StepNeighborhoodSchedule<LinearNeighborhoodSchedule>
+{
+
+public:
+    /**
+     * @brief Returns the neighborhood of the given step of the schedule.
+     */
+    int getNeighborhood(int step, int kmax) const noexcept
+    {
+        HIKE_UNUSED(kmax);
+
+        return step + 1;
+    }
+};
+
+/**
+ * @brief Walks the neighborhoods 1, f, f^2, ..., kmax (f being the growth factor),
+ * restarting from the first one when a solution is improved.
+ *
+ * The last neighborhood is always kmax, so the largest neighborhood is tried before finishing.
+ *
+ * See LinearNeighborhoodSchedule for the schedules interface.
+ */
+class GeometricNeighborhoodSchedule : public _StepNeighborhoodSchedule<GeometricNeighborhoodSchedule>
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param factor Growth factor between consecutive neighborhoods.
+     */
+    explicit GeometricNeighborhoodSchedule(double factor = 2) :
+        _factor(factor)
+    {
+        setFactor(factor);
+    }
+
+    /**
+     * @brief Returns the growth factor between consecutive neighborhoods.
+     */
+    double getFactor() const noexcept
+    {
+        return _factor;
+    }
+
+    /**
+     * @brief Specifies the growth factor between consecutive neighborhoods.
+     */
+    void setFactor(double factor)
+    {
+        HIKE_ASSERT(factor > 1);
+
+        _factor = factor;
+    }
+
+    /**
+     * @brief Returns the neighborhood of the given step of the schedule.
+     */
+    int getNeighborhood(int step, int kmax) const noexcept
+    {
+        int k = 1;
+
+        for(int index = 0; index < step; ++index)
+        {
+            if(k >= kmax)
+            {
+                return kmax + 1;
+            }
+
+            // Each neighborhood is at least one greater than the previous one, and kmax is never skipped:
+            int nextK = int(k * _factor);
+            k = nextK > k ? nextK : k + 1;
+
+            if(k > kmax)
+            {
+                k = kmax;
+            }
+        }
+
+        return k;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    double _factor;
+
+    ///@endcond
+};
+
+/**
+ * @brief Walks a user-provided sequence of neighborhoods, restarting from its first one
+ * when a solution is improved.
+ *
+ * The schedule finishes after the last neighborhood of the sequence or when a neighborhood greater than kmax
+ * is found.
+ *
+ * See LinearNeighborhoodSchedule for the schedules interface.
+ */
+class SequenceNeighborhoodSchedule : public _StepNeighborhoodSchedule<SequenceNeighborhoodSchedule>
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param neighborhoods Sequence of neighborhoods to walk.
+     */
+    explicit SequenceNeighborhoodSchedule(std::vector<int> neighborhoods) :
+        _neighborhoods(std::move(neighborhoods))
+    {
+        HIKE_ASSERT(! _neighborhoods.empty());
+
+        for(int k : _neighborhoods)
+        {
+            HIKE_ASSERT(k > 0);
+            HIKE_UNUSED(k);
+        }
+    }
+
+    /**
+     * @brief Returns the sequence of neighborhoods to walk.
+     */
+    const std::vector<int>& getNeighborhoods() const noexcept
+    {
+        return _neighborhoods;
+    }
+
+    /**
+     * @brief Returns the neighborhood of the given step of the schedule.
+     */
+    int getNeighborhood(int step, int kmax) const noexcept
+    {
+        if(std::size_t(step) >= _neighborhoods.size())
+        {
+            return kmax + 1;
+        }
+
+        int k = _neighborhoods[std::size_t(step)];
+        return k <= kmax ? k : kmax + 1;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    std::vector<int> _neighborhoods;
+
+    ///@endcond
+};
+
+}
+
+#endif
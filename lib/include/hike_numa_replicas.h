@@ -0,0 +1,105 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_NUMA_REPLICAS_H
+#define HIKE_NUMA_REPLICAS_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "hike_thread_pool.h"
+
+namespace hike
+{
+
+/**
+ * @brief Provides a copy of a read-only value per NUMA node.
+ *
+ * Each copy is created the first time a ThreadPool worker thread of its node requests it,
+ * so its memory is allocated in that node (first touch policy).
+ *
+ * Loss functions with large read-only data can use it to avoid cross-node memory traffic
+ * when losses are calculated in threads pinned to NUMA nodes (see NumaTopology::getPlacements).
+ *
+ * @tparam Type Copy constructible value type.
+ */
+template<class Type>
+class NumaReplicas
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param value Value to replicate.
+     * @param nodesCount Number of NUMA nodes (see NumaTopology::getNodes).
+     */
+    NumaReplicas(Type value, int nodesCount) :
+        _value(std::move(value)),
+        _replicas(std::size_t(nodesCount)),
+        _onceFlags(new std::once_flag[std::size_t(nodesCount)])
+    {
+        HIKE_ASSERT(nodesCount > 0);
+    }
+
+    /**
+     * @brief Returns the number of NUMA nodes.
+     */
+    int getNodesCount() const noexcept
+    {
+        return int(_replicas.size());
+    }
+
+    /**
+     * @brief Returns the copy of the value of the NUMA node of the calling ThreadPool worker thread,
+     * or the original value if it is not called from a ThreadPool worker thread.
+     *
+     * It is thread safe.
+     */
+    const Type& get() const
+    {
+        int node = ThreadPoolWorker::getNode();
+
+        if(node < 0 || node >= getNodesCount())
+        {
+            return _value;
+        }
+
+        std::unique_ptr<Type>& replica = _replicas[std::size_t(node)];
+
+        std::call_once(_onceFlags[std::size_t(node)], [this, &replica]
+        {
+            replica.reset(new Type(_value));
+        });
+
+        return *replica;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    Type _value;
+    mutable std::vector<std::unique_ptr<Type>> _replicas;
+    std::unique_ptr<std::once_flag[]> _onceFlags;
+
+    ///@endcond
+};
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_NUMA_TOPOLOGY_H
+#define HIKE_NUMA_TOPOLOGY_H
+
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Specifies where a thread must run.
+ */
+struct ThreadPlacement
+{
+    /**
+     * @brief Index of the CPU in which the thread must run, or -1 if it can run in any CPU.
+     */
+    int cpu = -1;
+
+    /**
+     * @brief Index of the NUMA node of the CPU in which the thread runs (see NumaTopology::getNodes).
+     */
+    int node = 0;
+
+    /**
+     * @brief Operating system identifier of the NUMA node of the CPU in which the thread runs
+     * (see NumaTopology::getNodeIds).
+     */
+    int nodeId = 0;
+};
+
+/**
+ * @brief Provides the CPUs of each NUMA node of the system.
+ *
+ * In Linux, it is read from /sys/devices/system/node. In other systems (or if it can't be read),
+ * all CPUs are considered part of the same node.
+ *
+ * Nodes without CPUs are not provided, so node indices can differ from their operating system identifiers.
+ *
+ * https://en.wikipedia.org/wiki/Non-uniform_memory_access
+ */
+class NumaTopology
+{
+
+public:
+    /**
+     * @brief Class constructor which reads the NUMA topology of the system.
+     */
+    NumaTopology()
+    {
+        #ifdef __linux__
+            // Node identifiers can have gaps, so the online nodes are enumerated instead of probing node0, node1...
+
+            std::ifstream onlineFile("/sys/devices/system/node/online");
+            std::string nodeList;
+
+            if(onlineFile && std::getline(onlineFile, nodeList))
+            {
+                for(int nodeId : _parseList(nodeList))
+                {
+                    std::ifstream file("/sys/devices/system/node/node" + std::to_string(nodeId) + "/cpulist");
+                    std::string cpuList;
+
+                    if(file && std::getline(file, cpuList))
+                    {
+                        std::vector<int> cpus = _parseList(cpuList);
+
+                        // Memory only nodes can't run threads:
+
+                        if(! cpus.empty())
+                        {
+                            _nodes.push_back(std::move(cpus));
+                            _nodeIds.push_back(nodeId);
+                        }
+                    }
+                }
+            }
+        #endif
+
+        if(_nodes.empty())
+        {
+            unsigned int cpusCount = std::max(std::thread::hardware_concurrency(), 1u);
+            _nodes.emplace_back();
+            _nodeIds.push_back(0);
+
+            for(unsigned int cpu = 0; cpu < cpusCount; ++cpu)
+            {
+                _nodes.back().push_back(int(cpu));
+            }
+        }
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param nodes CPUs of each NUMA node. Their operating system identifiers are their indices.
+     */
+    explicit NumaTopology(std::vector<std::vector<int>> nodes) :
+        _nodes(std::move(nodes))
+    {
+        HIKE_ASSERT(! _nodes.empty());
+
+        for(std::size_t node = 0; node < _nodes.size(); ++node)
+        {
+            _nodeIds.push_back(int(node));
+        }
+    }
+
+    /**
+     * @brief Returns the CPUs of each NUMA node.
+     */
+    const std::vector<std::vector<int>>& getNodes() const noexcept
+    {
+        return _nodes;
+    }
+
+    /**
+     * @brief Returns the operating system identifier of each NUMA node
+     * (N in /sys/devices/system/node/nodeN), in the same order as getNodes.
+     */
+    const std::vector<int>& getNodeIds() const noexcept
+    {
+        return _nodeIds;
+    }
+
+    /**
+     * @brief Returns a list of threads pinned to CPUs, with the given number of threads per NUMA node.
+     *
+     * If a node has less CPUs than the given number of threads, some of its CPUs run multiple threads.
+     */
+    std::vector<ThreadPlacement> getPlacements(unsigned int threadsPerNode) const
+    {
+        HIKE_ASSERT(threadsPerNode > 0);
+
+        std::vector<ThreadPlacement> placements;
+        placements.reserve(_nodes.size() * threadsPerNode);
+
+        for(std::size_t node = 0; node < _nodes.size(); ++node)
+        {
+            const std::vector<int>& cpus = _nodes[node];
+
+            for(unsigned int thread = 0; thread < threadsPerNode; ++thread)
+            {
+                ThreadPlacement placement;
+                placement.cpu = cpus[thread % cpus.size()];
+                placement.node = int(node);
+                placement.nodeId = _nodeIds[node];
+                placements.push_back(placement);
+            }
+        }
+
+        return placements;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    std::vector<std::vector<int>> _nodes;
+    std::vector<int> _nodeIds;
+
+    static std::vector<int> _parseList(const std::string& list)
+    {
+        // CPU and node lists have this format: 0-3,8,10-11
+
+        std::vector<int> values;
+        const char* data = list.c_str();
+
+        while(*data)
+        {
+            char* end;
+            long firstValue = std::strtol(data, &end, 10);
+
+            if(end == data)
+            {
+                break;
+            }
+
+            long lastValue = firstValue;
+            data = end;
+
+            if(*data == '-')
+            {
+                ++data;
+                lastValue = std::strtol(data, &end, 10);
+
+                if(end == data)
+                {
+                    break;
+                }
+
+                data = end;
+            }
+
+            for(long value = firstValue; value <= lastValue; ++value)
+            {
+                values.push_back(int(value));
+            }
+
+            if(*data == ',')
+            {
+                ++data;
+            }
+        }
+
+        return values;
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
@@ -19,21 +19,74 @@
 #ifndef HIKE_PARALLEL_BI_LOCAL_SEARCH_H
 #define HIKE_PARALLEL_BI_LOCAL_SEARCH_H
 
+#include <memory>
+#include <algorithm>
 #include "hike_local_search_base.h"
 #include "hike_empty_on_improved_solution.h"
-#include "hike_thread_pool.h"
+#include "hike_thread_pool_evaluator.h"
 
 namespace hike
 {
 
+/**
+ * @brief Candidate solution type evaluated by default in ParallelBILocalSearch:
+ * SolutionMove if the given loss function supports solution moves (see HasMoveLoss), otherwise Solution.
+ */
+template<class Solution, class LossFunction>
+using ParallelBICandidate = typename std::conditional<HasMoveLoss<LossFunction, Solution>::value,
+                                                      SolutionMove<Solution>, Solution>::type;
+
+///@cond INTERNAL
+
+template<class Type>
+struct _Void
+{
+    using type = void;
+};
+
+template<class Evaluator, class Solution, class = void>
+struct _EvaluatorCandidate
+{
+    using type = Solution;
+};
+
+template<class Evaluator, class Solution>
+struct _EvaluatorCandidate<Evaluator, Solution, typename _Void<typename Evaluator::Candidate>::type>
+{
+    using type = typename Evaluator::Candidate;
+};
+
+///@endcond
+
 /**
  * @brief Multithread best improvement (highest descent) local search.
  *
  * https://en.wikipedia.org/wiki/Variable_neighborhood_search
  *
- * Please note than the given loss function must be thread safe.
+ * Losses are calculated in parallel by an Evaluator object, which is a ThreadPoolEvaluator by default.
+ * In that case, the given loss function must be thread safe.
+ *
+ * An Evaluator must provide this method:
+ *
+ * @code
+ * void operator()(LossFunction& lossFunction,
+ *                 std::vector<std::pair<Candidate, LossType>, CandidatesAllocator>& candidatesAndLosses,
+ *                 const LossType& cutoff);
+ * @endcode
+ *
+ * Candidate is Evaluator::Candidate if it is defined, otherwise Solution.
+ * If Candidate is SolutionMove<Solution>, candidate solutions are not copied:
+ * only the best one is created after calculating their losses.
+ *
+ * Candidate solutions are recycled between steps, and internal buffers are allocated with a default constructed
+ * Allocator (see PoolAllocator), so no memory is allocated after the first steps.
+ *
+ * The latency of each step can be capped with the deadline or the quantile cutoff of ThreadPoolEvaluator:
+ * the best candidate is then selected among the ones evaluated in time.
  */
-template<class Solution, class LossFunction, class OnImprovedSolution = EmptyOnImprovedSolution>
+template<class Solution, class LossFunction, class OnImprovedSolution = EmptyOnImprovedSolution,
+         class Evaluator = ThreadPoolEvaluator<ParallelBICandidate<Solution, LossFunction>, LossFunction>,
+         class Allocator = std::allocator<Solution>>
 class ParallelBILocalSearch : public LocalSearchBase<LossFunction, OnImprovedSolution>
 {
 
@@ -66,8 +119,70 @@ public:
         _BaseClass(std::forward<LossFunctionType>(lossFunction),
                    std::forward<OnImprovedSolutionType>(onImprovedSolution), neighborhood),
         _stepSolution(std::forward<SolutionType>(stepSolution)),
-        _threadPool(new ThreadPool<LossTask>())
+        _improvedSolution(_stepSolution),
+        _surrogateCandidates(0)
+    {
+    }
+
+    /**
+     * @brief Returns the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     */
+    const Solution& getStepSolution() const noexcept
+    {
+        return _stepSolution;
+    }
+
+    /**
+     * @brief Specifies the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     *
+     * Parameters with a zero step are not changed, so the search can be restricted to a subset of parameters
+     * (see VNDS).
+     */
+    void setStepSolution(const Solution& stepSolution)
+    {
+        _stepSolution = stepSolution;
+    }
+
+    /**
+     * @brief Returns the object used to calculate the losses of the candidate solutions.
+     */
+    const Evaluator& getEvaluator() const noexcept
+    {
+        return _evaluator;
+    }
+
+    /**
+     * @brief Returns the object used to calculate the losses of the candidate solutions.
+     */
+    Evaluator& getEvaluator() noexcept
+    {
+        return _evaluator;
+    }
+
+    /**
+     * @brief Returns the maximum number of candidate solutions whose exact loss is calculated in each step
+     * if the loss function provides surrogate losses (see HasSurrogate).
+     *
+     * If it is greater than zero, all candidate solutions are sorted by their surrogate loss,
+     * and only the exact loss of the best ones is calculated. Zero means that surrogate losses are not used.
+     */
+    std::size_t getSurrogateCandidates() const noexcept
     {
+        return _surrogateCandidates;
+    }
+
+    /**
+     * @brief Specifies the maximum number of candidate solutions whose exact loss is calculated in each step
+     * if the loss function provides surrogate losses (see HasSurrogate).
+     *
+     * If it is greater than zero, all candidate solutions are sorted by their surrogate loss,
+     * and only the exact loss of the best ones is calculated. Zero means that surrogate losses are not used.
+     */
+    void setSurrogateCandidates(std::size_t surrogateCandidates)
+    {
+        _surrogateCandidates = surrogateCandidates;
     }
 
     /**
@@ -95,68 +210,211 @@ public:
         HIKE_ASSERT(solution.size() == _stepSolution.size());
 
         Solution bestSolution = std::forward<SolutionType>(solution);
-        _optimize<false>(0, solution);
+        optimized = _optimizeSolution(bestSolution);
+
+        return bestSolution;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution,
+     * reusing the memory of the output solution.
+     * @param solution The solution to optimize.
+     * @param optimizedSolution Output parameter which contains the optimized solution.
+     * @param optimized Output parameter which indicates if the given solution has been optimized or not.
+     */
+    void optimize(const Solution& solution, Solution& optimizedSolution, bool& optimized)
+    {
+        HIKE_ASSERT(solution.size() == _stepSolution.size());
+
+        optimizedSolution = solution;
+        optimized = _optimizeSolution(optimizedSolution);
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    using _BaseClass = LocalSearchBase<LossFunction, OnImprovedSolution>;
+    using LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+    using Candidate = typename _EvaluatorCandidate<Evaluator, Solution>::type;
+    using CandidateLossPair = std::pair<Candidate, LossType>;
+    using ParamChange = typename SolutionMove<Solution>::ParamChange;
+
+    using SurrogateLoss = SurrogateLossType<LossFunction, Candidate>;
+
+    template<class Type>
+    using _Allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Type>;
+
+    template<class Type>
+    using _Vector = std::vector<Type, _Allocator<Type>>;
+
+    static constexpr bool _moveCandidates = std::is_same<Candidate, SolutionMove<Solution>>::value;
+
+    Solution _stepSolution;
+    Solution _improvedSolution;
+    _Vector<CandidateLossPair> _candidatesAndLosses;
+    _Vector<CandidateLossPair> _bestCandidatesAndLosses;
+    _Vector<Solution> _recycledSolutions;
+    _Vector<std::pair<SurrogateLoss, std::size_t>> _surrogateLosses;
+
+    // Solution moves reference a std::vector storage, so it doesn't use the given allocator:
+    std::vector<ParamChange> _paramChanges;
 
-        for(SolutionLossPair& solutionAndLoss : _solutionsAndLosses)
+    _Vector<ParamChange> _currentParamChanges;
+    Evaluator _evaluator;
+    std::size_t _surrogateCandidates;
+
+    bool _optimizeSolution(Solution& bestSolution)
+    {
+        auto bestLoss = _BaseClass::_lossFunction(bestSolution);
+        _optimize(0, bestSolution);
+
+        if(_surrogateCandidates && HasSurrogate<LossFunction, Candidate>::value)
         {
-            _threadPool->add(LossTask(_BaseClass::_lossFunction, solutionAndLoss));
+            // Only the exact loss of the best candidates (sorted by their surrogate loss) is calculated:
+
+            _keepBestSurrogateCandidates();
         }
 
-        auto bestLoss = _BaseClass::_lossFunction(bestSolution);
-        _threadPool->join();
-        optimized = false;
+        _evaluator(_BaseClass::_lossFunction, _candidatesAndLosses, bestLoss);
+        _BaseClass::_evaluationsCount += _candidatesAndLosses.size();
+
+        auto inputLoss = bestLoss;
+        CandidateLossPair* bestCandidateAndLoss = nullptr;
 
-        for(SolutionLossPair& solutionAndLoss : _solutionsAndLosses)
+        for(CandidateLossPair& candidateAndLoss : _candidatesAndLosses)
         {
-            auto loss = solutionAndLoss.second;
+            auto loss = candidateAndLoss.second;
 
             if(loss < bestLoss)
             {
-                Solution& improvedSolution = solutionAndLoss.first;
-                _BaseClass::_onImprovedSolution(bestSolution, bestLoss, improvedSolution, loss, _BaseClass::_neighborhood);
-                bestSolution = std::move(improvedSolution);
+                bestCandidateAndLoss = &candidateAndLoss;
                 bestLoss = loss;
-                optimized = true;
             }
         }
 
-        _solutionsAndLosses.clear();
+        bool optimized = bestCandidateAndLoss != nullptr;
 
-        return bestSolution;
+        if(optimized)
+        {
+            _setImprovedSolution(bestSolution, bestCandidateAndLoss->first);
+            _BaseClass::_onImprovedSolution(bestSolution, inputLoss, _improvedSolution, bestLoss,
+                                            _BaseClass::_neighborhood);
+            std::swap(bestSolution, _improvedSolution);
+        }
+
+        _recycleCandidates(_candidatesAndLosses);
+        _paramChanges.clear();
+
+        return optimized;
     }
 
-protected:
-    ///@cond INTERNAL
+    void _keepBestSurrogateCandidates()
+    {
+        for(std::size_t index = 0, size = _candidatesAndLosses.size(); index < size; ++index)
+        {
+            _surrogateLosses.push_back(std::make_pair(_surrogate(_candidatesAndLosses[index].first), index));
+        }
 
-    using _BaseClass = LocalSearchBase<LossFunction, OnImprovedSolution>;
-    using LossType = typename std::result_of<LossFunction(const Solution&)>::type;
-    using SolutionLossPair = std::pair<Solution, LossType>;
+        auto lastSurrogateLossIt = _surrogateLosses.begin() +
+                std::ptrdiff_t(std::min(_surrogateCandidates, _surrogateLosses.size()));
+        std::partial_sort(_surrogateLosses.begin(), lastSurrogateLossIt, _surrogateLosses.end());
+
+        for(auto surrogateLossIt = _surrogateLosses.begin(); surrogateLossIt != lastSurrogateLossIt;
+            ++surrogateLossIt)
+        {
+            _bestCandidatesAndLosses.push_back(std::move(_candidatesAndLosses[surrogateLossIt->second]));
+        }
+
+        _candidatesAndLosses.swap(_bestCandidatesAndLosses);
+        _recycleCandidates(_bestCandidatesAndLosses);
+        _surrogateLosses.clear();
+    }
+
+    SurrogateLoss _surrogate(const Candidate& candidate)
+    {
+        return _surrogate(candidate, std::integral_constant<bool, HasSurrogate<LossFunction, Candidate>::value>());
+    }
+
+    SurrogateLoss _surrogate(const Candidate& candidate, std::true_type)
+    {
+        return _BaseClass::_lossFunction.surrogate(candidate);
+    }
+
+    SurrogateLoss _surrogate(const Candidate& candidate, std::false_type)
+    {
+        return _BaseClass::_lossFunction(candidate);
+    }
+
+    void _setImprovedSolution(const Solution&, Solution& candidate)
+    {
+        // The previous improved solution is recycled as a candidate:
+
+        std::swap(_improvedSolution, candidate);
+    }
 
-    class LossTask
+    void _setImprovedSolution(const Solution& baseSolution, const SolutionMove<Solution>& candidate)
     {
+        _improvedSolution = baseSolution;
+        candidate.apply(_improvedSolution);
+    }
 
-    public:
-        LossTask(LossFunction& lossFunction, SolutionLossPair& solutionAndLoss) :
-            _lossFunction(lossFunction),
-            _solutionAndLoss(solutionAndLoss)
+    void _recycleCandidates(_Vector<CandidateLossPair>& candidatesAndLosses)
+    {
+        for(CandidateLossPair& candidateAndLoss : candidatesAndLosses)
         {
+            _recycleCandidate(candidateAndLoss.first);
         }
 
-        void operator()()
+        candidatesAndLosses.clear();
+    }
+
+    void _recycleCandidate(Solution& candidate)
+    {
+        _recycledSolutions.push_back(std::move(candidate));
+    }
+
+    void _recycleCandidate(const SolutionMove<Solution>&)
+    {
+    }
+
+    void _pushCandidate(const Solution& solution, std::false_type)
+    {
+        if(_recycledSolutions.empty())
         {
-            _solutionAndLoss.second = _lossFunction(_solutionAndLoss.first);
+            _candidatesAndLosses.push_back(std::make_pair(solution, LossType()));
         }
+        else
+        {
+            // Assigning the solution to a recycled one reuses its memory:
 
-    protected:
-        LossFunction& _lossFunction;
-        SolutionLossPair& _solutionAndLoss;
-    };
+            Solution& recycledSolution = _recycledSolutions.back();
+            recycledSolution = solution;
+            _candidatesAndLosses.push_back(std::make_pair(std::move(recycledSolution), LossType()));
+            _recycledSolutions.pop_back();
+        }
+    }
 
-    Solution _stepSolution;
-    std::vector<SolutionLossPair> _solutionsAndLosses;
-    std::unique_ptr<ThreadPool<LossTask>> _threadPool;
+    void _pushCandidate(const Solution& solution, std::true_type)
+    {
+        // Only the changed parameters are stored (the base solution is restored when the enumeration finishes):
+
+        std::size_t firstParamChange = _paramChanges.size();
+        _paramChanges.insert(_paramChanges.end(), _currentParamChanges.begin(), _currentParamChanges.end());
+
+        SolutionMove<Solution> move(solution, _paramChanges, firstParamChange, _currentParamChanges.size());
+        _candidatesAndLosses.push_back(std::make_pair(move, LossType()));
+    }
+
+    void _addCandidate(std::size_t paramIndex, Solution& solution)
+    {
+        if(_moveCandidates)
+        {
+            _currentParamChanges.push_back(ParamChange{ paramIndex, solution[paramIndex] });
+        }
+
+        _pushCandidate(solution, std::integral_constant<bool, _moveCandidates>());
+    }
 
-    template<bool checkCurrentStep>
     void _optimize(std::size_t paramIndex, Solution& solution)
     {
         if(paramIndex < solution.size())
@@ -164,30 +422,41 @@ protected:
             auto currentParam = solution[paramIndex];
             auto stepParam = _stepSolution[paramIndex] * _BaseClass::_neighborhood;
 
+            if(_BaseClass::_isFrozen(stepParam))
+            {
+                _optimize(paramIndex + 1, solution);
+                return;
+            }
+
             // Previous step check:
 
             solution[paramIndex] = currentParam - stepParam;
-            _solutionsAndLosses.push_back(std::make_pair(solution, LossType()));
+            _addCandidate(paramIndex, solution);
 
-            _optimize<true>(paramIndex + 1, solution);
+            _optimize(paramIndex + 1, solution);
 
-            // Current step check:
-
-            solution[paramIndex] = currentParam;
-
-            if(checkCurrentStep)
+            if(_moveCandidates)
             {
-                _solutionsAndLosses.push_back(std::make_pair(solution, LossType()));
+                _currentParamChanges.pop_back();
             }
 
-            _optimize<true>(paramIndex + 1, solution);
+            // Current step check (current step candidates have been already added by the previous parameters):
+
+            solution[paramIndex] = currentParam;
+
+            _optimize(paramIndex + 1, solution);
 
             // Next step check:
 
             solution[paramIndex] = currentParam + stepParam;
-            _solutionsAndLosses.push_back(std::make_pair(solution, LossType()));
+            _addCandidate(paramIndex, solution);
+
+            _optimize(paramIndex + 1, solution);
 
-            _optimize<true>(paramIndex + 1, solution);
+            if(_moveCandidates)
+            {
+                _currentParamChanges.pop_back();
+            }
 
             // Restore solution:
 
@@ -0,0 +1,439 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+
+#ifndef HIKE_PARALLEL_FI_LOCAL_SEARCH_H
+#define HIKE_PARALLEL_FI_LOCAL_SEARCH_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "hike_local_search_base.h"
+#include "hike_empty_on_improved_solution.h"
+#include "hike_thread_pool.h"
+
+namespace hike
+{
+
+/**
+ * @brief Multithread first improvement (first descent) local search.
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ *
+ * Candidate solutions are enumerated in the same order as in FILocalSearch and grouped in windows,
+ * whose losses are calculated in parallel in the threads of a ThreadPool.
+ * The earliest improving candidate of each window in enumeration order is taken, and the losses of the candidates
+ * which follow it are not calculated if they have not been started yet.
+ *
+ * Optimized solutions are the same as the ones of FILocalSearch without don't look bits and move ordering.
+ *
+ * The given loss function must be thread safe.
+ */
+template<class Solution, class LossFunction, class OnImprovedSolution = EmptyOnImprovedSolution>
+class ParallelFILocalSearch : public LocalSearchBase<LossFunction, OnImprovedSolution>
+{
+
+public:
+    /**
+     * @brief Class constructor.
+     * @param lossFunction A solution that minimizes this function is an optimal solution. It must be thread safe.
+     * @param stepSolution Candidate solutions are generated adding and subtracting
+     * the parameters of this solution to the input one.
+     * @param neighborhood Distance between the candidate solutions and the input one.
+     */
+    template<class LossFunctionType, class SolutionType>
+    ParallelFILocalSearch(LossFunctionType&& lossFunction, SolutionType&& stepSolution, int neighborhood = 1) :
+        ParallelFILocalSearch(std::forward<LossFunctionType>(lossFunction), std::forward<SolutionType>(stepSolution),
+                              OnImprovedSolution(), neighborhood)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param lossFunction A solution that minimizes this function is an optimal solution. It must be thread safe.
+     * @param stepSolution Candidate solutions are generated adding and subtracting
+     * the parameters of this solution to the input one.
+     * @param onImprovedSolution Callback called when a given solution is improved.
+     * @param neighborhood Distance between the candidate solutions and the input one.
+     */
+    template<class LossFunctionType, class SolutionType, class OnImprovedSolutionType>
+    ParallelFILocalSearch(LossFunctionType&& lossFunction, SolutionType&& stepSolution,
+                          OnImprovedSolutionType&& onImprovedSolution, int neighborhood = 1) :
+        _BaseClass(std::forward<LossFunctionType>(lossFunction),
+                   std::forward<OnImprovedSolutionType>(onImprovedSolution), neighborhood),
+        _stepSolution(std::forward<SolutionType>(stepSolution)),
+        _threadPool(new ThreadPool<EvaluationTask>()),
+        _windowSize(_threadPool->getThreadsCount() * 2),
+        _window(new Window()),
+        _candidatesCount(0)
+    {
+    }
+
+    /**
+     * @brief Returns the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     */
+    const Solution& getStepSolution() const noexcept
+    {
+        return _stepSolution;
+    }
+
+    /**
+     * @brief Specifies the solution whose parameters are added to and subtracted from the input one
+     * to generate candidate solutions.
+     *
+     * Parameters with a zero step are not changed, so the search can be restricted to a subset of parameters
+     * (see VNDS).
+     */
+    void setStepSolution(const Solution& stepSolution)
+    {
+        _stepSolution = stepSolution;
+    }
+
+    /**
+     * @brief Returns the number of threads used to calculate losses.
+     */
+    std::size_t getThreadsCount() const noexcept
+    {
+        return _threadPool->getThreadsCount();
+    }
+
+    /**
+     * @brief Specifies the number of threads used to calculate losses.
+     */
+    void setThreadsCount(unsigned int threads)
+    {
+        std::unique_ptr<ThreadPool<EvaluationTask>> threadPool(new ThreadPool<EvaluationTask>(threads));
+        threadPool->setSpinCount(_threadPool->getSpinCount());
+        threadPool->setCallerParticipationEnabled(_threadPool->isCallerParticipationEnabled());
+        _threadPool = std::move(threadPool);
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::getSpinCount).
+     */
+    int getSpinCount() const noexcept
+    {
+        return _threadPool->getSpinCount();
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::setSpinCount).
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        _threadPool->setSpinCount(spinCount);
+    }
+
+    /**
+     * @brief Indicates if the calling thread calculates pending losses too instead of waiting for the managed threads
+     * (see ThreadPool::isCallerParticipationEnabled).
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _threadPool->isCallerParticipationEnabled();
+    }
+
+    /**
+     * @brief Specifies if the calling thread calculates pending losses too instead of waiting for the managed threads
+     * (disabled by default, see ThreadPool::setCallerParticipationEnabled).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _threadPool->setCallerParticipationEnabled(enabled);
+    }
+
+    /**
+     * @brief Returns the maximum number of candidate solutions whose losses are calculated at the same time.
+     *
+     * Greater windows reduce the synchronization overhead, but more losses are calculated after the first
+     * improving candidate. By default it is twice the number of threads.
+     */
+    std::size_t getWindowSize() const noexcept
+    {
+        return _windowSize;
+    }
+
+    /**
+     * @brief Specifies the maximum number of candidate solutions whose losses are calculated at the same time.
+     *
+     * Greater windows reduce the synchronization overhead, but more losses are calculated after the first
+     * improving candidate. By default it is twice the number of threads.
+     */
+    void setWindowSize(std::size_t windowSize)
+    {
+        HIKE_ASSERT(windowSize > 0);
+
+        _windowSize = windowSize;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution)
+    {
+        bool optimized;
+
+        return optimize(std::forward<SolutionType>(solution), optimized);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @param optimized Output parameter which indicates if the given solution has been optimized or not.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution, bool& optimized)
+    {
+        HIKE_ASSERT(solution.size() == _stepSolution.size());
+
+        Solution bestSolution = std::forward<SolutionType>(solution);
+        optimized = _optimizeSolution(bestSolution);
+
+        return bestSolution;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution,
+     * reusing the memory of the output solution.
+     * @param solution The solution to optimize.
+     * @param optimizedSolution Output parameter which contains the optimized solution.
+     * @param optimized Output parameter which indicates if the given solution has been optimized or not.
+     */
+    void optimize(const Solution& solution, Solution& optimizedSolution, bool& optimized)
+    {
+        HIKE_ASSERT(solution.size() == _stepSolution.size());
+
+        optimizedSolution = solution;
+        optimized = _optimizeSolution(optimizedSolution);
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    using _BaseClass = LocalSearchBase<LossFunction, OnImprovedSolution>;
+    using LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+
+    class EvaluationTask
+    {
+
+    public:
+        EvaluationTask(ParallelFILocalSearch& localSearch, std::size_t candidateIndex) :
+            _localSearch(localSearch),
+            _candidateIndex(candidateIndex)
+        {
+        }
+
+        void operator()()
+        {
+            _localSearch._evaluateCandidate(_candidateIndex);
+        }
+
+    protected:
+        ParallelFILocalSearch& _localSearch;
+        std::size_t _candidateIndex;
+    };
+
+    // State shared by the threads which evaluate a window (allocated apart so this object stays movable):
+    struct Window
+    {
+        LossType cutoff;
+        std::atomic<std::size_t> firstImprovedIndex;
+        std::atomic<std::size_t> evaluatedCount;
+    };
+
+    Solution _stepSolution;
+    std::unique_ptr<ThreadPool<EvaluationTask>> _threadPool;
+    std::size_t _windowSize;
+    std::unique_ptr<Window> _window;
+    std::vector<Solution> _candidates;
+    std::vector<LossType> _losses;
+    std::size_t _candidatesCount;
+
+    bool _optimizeSolution(Solution& solution)
+    {
+        auto bestLoss = _BaseClass::_lossFunction(solution);
+        _candidatesCount = 0;
+
+        // The enumeration is stopped when a window contains an improving candidate,
+        // and the last window is evaluated when it finishes:
+
+        if(! _optimize<false>(0, bestLoss, solution) && ! _evaluateCandidates(bestLoss))
+        {
+            return false;
+        }
+
+        std::size_t improvedIndex = _window->firstImprovedIndex.load(std::memory_order_relaxed);
+        std::swap(solution, _candidates[improvedIndex]);
+        _BaseClass::_onImprovedSolution(bestLoss, solution, _losses[improvedIndex], _BaseClass::_neighborhood);
+        _candidatesCount = 0;
+        return true;
+    }
+
+    bool _addCandidate(const Solution& solution, const LossType& bestLoss)
+    {
+        // Assigning the solution to a previous candidate reuses its memory:
+
+        if(_candidatesCount < _candidates.size())
+        {
+            _candidates[_candidatesCount] = solution;
+        }
+        else
+        {
+            _candidates.push_back(solution);
+            _losses.push_back(LossType());
+        }
+
+        ++_candidatesCount;
+        return _candidatesCount >= _windowSize && _evaluateCandidates(bestLoss);
+    }
+
+    bool _evaluateCandidates(const LossType& bestLoss)
+    {
+        std::size_t candidatesCount = _candidatesCount;
+
+        if(! candidatesCount)
+        {
+            return false;
+        }
+
+        _window->cutoff = bestLoss;
+        _window->firstImprovedIndex.store(candidatesCount, std::memory_order_relaxed);
+        _window->evaluatedCount.store(0, std::memory_order_relaxed);
+
+        for(std::size_t candidateIndex = 0; candidateIndex < candidatesCount; ++candidateIndex)
+        {
+            _threadPool->add(EvaluationTask(*this, candidateIndex));
+        }
+
+        _threadPool->join();
+        _BaseClass::_evaluationsCount += _window->evaluatedCount.load(std::memory_order_relaxed);
+        _candidatesCount = 0;
+
+        return _window->firstImprovedIndex.load(std::memory_order_relaxed) < candidatesCount;
+    }
+
+    void _evaluateCandidate(std::size_t candidateIndex)
+    {
+        // Candidates which follow an improving one are not needed:
+
+        if(_window->firstImprovedIndex.load(std::memory_order_acquire) < candidateIndex)
+        {
+            return;
+        }
+
+        LossType loss = evaluateLoss(_BaseClass::_lossFunction, _candidates[candidateIndex], _window->cutoff);
+        _losses[candidateIndex] = loss;
+        _window->evaluatedCount.fetch_add(1, std::memory_order_relaxed);
+
+        if(loss < _window->cutoff)
+        {
+            std::size_t firstImprovedIndex = _window->firstImprovedIndex.load(std::memory_order_relaxed);
+
+            while(candidateIndex < firstImprovedIndex &&
+                  ! _window->firstImprovedIndex.compare_exchange_weak(firstImprovedIndex, candidateIndex,
+                                                              std::memory_order_acq_rel))
+            {
+            }
+        }
+    }
+
+    template<bool checkCurrentStep>
+    bool _optimize(std::size_t paramIndex, const LossType& bestLoss, Solution& solution)
+    {
+        // Same enumeration as FILocalSearch::_optimize, with candidates added to the current window
+        // instead of being evaluated one by one:
+
+        if(paramIndex >= solution.size())
+        {
+            return false;
+        }
+
+        auto currentParam = solution[paramIndex];
+        auto stepParam = _stepSolution[paramIndex] * _BaseClass::_neighborhood;
+
+        if(_BaseClass::_isFrozen(stepParam))
+        {
+            return _optimize<checkCurrentStep>(paramIndex + 1, bestLoss, solution);
+        }
+
+        // First step check:
+
+        solution[paramIndex] = currentParam - stepParam;
+
+        if(_addCandidate(solution, bestLoss))
+        {
+            return true;
+        }
+
+        if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss) &&
+           _optimize<true>(paramIndex + 1, bestLoss, solution))
+        {
+            return true;
+        }
+
+        // Current step check:
+
+        solution[paramIndex] = currentParam;
+
+        if(checkCurrentStep && _addCandidate(solution, bestLoss))
+        {
+            return true;
+        }
+
+        if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss) &&
+           _optimize<true>(paramIndex + 1, bestLoss, solution))
+        {
+            return true;
+        }
+
+        // Last step check:
+
+        solution[paramIndex] = currentParam + stepParam;
+
+        if(_addCandidate(solution, bestLoss))
+        {
+            return true;
+        }
+
+        if(! _BaseClass::_skipNextParams(solution, paramIndex, bestLoss) &&
+           _optimize<true>(paramIndex + 1, bestLoss, solution))
+        {
+            return true;
+        }
+
+        // Restore solution:
+
+        solution[paramIndex] = currentParam;
+
+        return false;
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_POOL_ALLOCATOR_H
+#define HIKE_POOL_ALLOCATOR_H
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Recycles small memory blocks instead of returning them to the global heap.
+ *
+ * Blocks are grouped in size classes. Freed blocks are kept in a free list per size class
+ * and reused by the next allocations of the same size class, so containers which are filled and cleared
+ * repeatedly (like loss caches or candidate solutions) stop hitting the global heap after warming up.
+ *
+ * Blocks larger than the maximum block size are allocated from the global heap directly.
+ *
+ * It is not thread safe.
+ */
+class MemoryPool
+{
+
+public:
+    /**
+     * @brief Maximum size in bytes of the blocks managed by the pool.
+     */
+    static constexpr std::size_t maxBlockSize = 512;
+
+    /**
+     * @brief Alignment in bytes of the blocks managed by the pool.
+     */
+    static constexpr std::size_t alignment = 16;
+
+    /**
+     * @brief Class constructor.
+     * @param chunkSize Size in bytes of the memory chunks requested to the global heap.
+     */
+    explicit MemoryPool(std::size_t chunkSize = 64 * 1024) :
+        _chunkSize(chunkSize),
+        _chunkOffset(chunkSize)
+    {
+        HIKE_ASSERT(chunkSize >= maxBlockSize);
+
+        for(void*& freeBlock : _freeBlocks)
+        {
+            freeBlock = nullptr;
+        }
+    }
+
+    /**
+     * @brief Class destructor, which returns all memory chunks to the global heap.
+     */
+    ~MemoryPool()
+    {
+        for(char* chunk : _chunks)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    MemoryPool(const MemoryPool& other) = delete;
+    MemoryPool& operator=(const MemoryPool& other) = delete;
+
+    /**
+     * @brief Returns a memory block of the given size.
+     */
+    void* allocate(std::size_t size)
+    {
+        if(size > maxBlockSize)
+        {
+            return ::operator new(size);
+        }
+
+        std::size_t sizeClass = _sizeClass(size);
+        void* block = _freeBlocks[sizeClass];
+
+        if(block)
+        {
+            _freeBlocks[sizeClass] = *static_cast<void**>(block);
+            return block;
+        }
+
+        std::size_t blockSize = (sizeClass + 1) * alignment;
+
+        if(_chunkOffset + blockSize > _chunkSize)
+        {
+            _chunks.push_back(static_cast<char*>(::operator new(_chunkSize)));
+            _chunkOffset = 0;
+        }
+
+        block = _chunks.back() + _chunkOffset;
+        _chunkOffset += blockSize;
+        return block;
+    }
+
+    /**
+     * @brief Returns a memory block provided by allocate to the pool.
+     * @param block Memory block to return.
+     * @param size Size of the memory block (the same value passed to allocate).
+     */
+    void deallocate(void* block, std::size_t size) noexcept
+    {
+        if(size > maxBlockSize)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        std::size_t sizeClass = _sizeClass(size);
+        *static_cast<void**>(block) = _freeBlocks[sizeClass];
+        _freeBlocks[sizeClass] = block;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    std::vector<char*> _chunks;
+    void* _freeBlocks[maxBlockSize / alignment];
+    std::size_t _chunkSize;
+    std::size_t _chunkOffset;
+
+    static std::size_t _sizeClass(std::size_t size) noexcept
+    {
+        return size ? (size - 1) / alignment : 0;
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Standard allocator which gets its memory from a MemoryPool.
+ *
+ * Copies of an allocator (including rebound ones) share the same MemoryPool,
+ * so it can be passed to multiple containers.
+ *
+ * It is not thread safe.
+ */
+template<class Type>
+class PoolAllocator
+{
+
+public:
+    /**
+     * Allocated object type.
+     */
+    using value_type = Type;
+
+    /**
+     * @brief Class constructor which creates a new MemoryPool.
+     */
+    PoolAllocator() :
+        _memoryPool(std::make_shared<MemoryPool>())
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param memoryPool Pool from which memory is allocated.
+     */
+    explicit PoolAllocator(std::shared_ptr<MemoryPool> memoryPool) noexcept :
+        _memoryPool(std::move(memoryPool))
+    {
+        HIKE_ASSERT(_memoryPool);
+    }
+
+    /**
+     * @brief Class constructor which shares the MemoryPool of the given allocator.
+     */
+    template<class OtherType>
+    PoolAllocator(const PoolAllocator<OtherType>& other) noexcept :
+        _memoryPool(other.getMemoryPool())
+    {
+    }
+
+    /**
+     * @brief Returns the pool from which memory is allocated.
+     */
+    const std::shared_ptr<MemoryPool>& getMemoryPool() const noexcept
+    {
+        return _memoryPool;
+    }
+
+    /**
+     * @brief Allocates memory for the given number of objects.
+     */
+    Type* allocate(std::size_t count)
+    {
+        static_assert(alignof(Type) <= MemoryPool::alignment, "Type alignment is not supported");
+
+        return static_cast<Type*>(_memoryPool->allocate(count * sizeof(Type)));
+    }
+
+    /**
+     * @brief Returns memory provided by allocate to the pool.
+     */
+    void deallocate(Type* pointer, std::size_t count) noexcept
+    {
+        _memoryPool->deallocate(pointer, count * sizeof(Type));
+    }
+
+    /**
+     * @brief Indicates if memory allocated by one of the given allocators can be deallocated by the other one.
+     */
+    template<class OtherType>
+    bool operator==(const PoolAllocator<OtherType>& other) const noexcept
+    {
+        return _memoryPool == other.getMemoryPool();
+    }
+
+    /**
+     * @brief Indicates if memory allocated by one of the given allocators can't be deallocated by the other one.
+     */
+    template<class OtherType>
+    bool operator!=(const PoolAllocator<OtherType>& other) const noexcept
+    {
+        return _memoryPool != other.getMemoryPool();
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    std::shared_ptr<MemoryPool> _memoryPool;
+
+    ///@endcond
+};
+
+}
+
+#endif
@@ -0,0 +1,534 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_PROCESS_POOL_EVALUATOR_H
+#define HIKE_PROCESS_POOL_EVALUATOR_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include "hike_loss_function_traits.h"
+#include "hike_serializer.h"
+
+namespace hike
+{
+
+///@cond INTERNAL
+
+// Parent side sockets of the workers of every ProcessPoolEvaluator, so forked workers can close them all.
+// Otherwise, workers of other evaluators would keep them open, and they would never stop serving:
+class _WorkerSockets
+{
+
+public:
+    static _WorkerSockets& get()
+    {
+        static _WorkerSockets workerSockets;
+        return workerSockets;
+    }
+
+    std::mutex& getMutex() noexcept
+    {
+        return _mutex;
+    }
+
+    // The following methods must be called with the mutex locked:
+
+    void add(int socket)
+    {
+        _sockets.push_back(socket);
+    }
+
+    void close(int socket)
+    {
+        // The socket is removed before closing it, since its descriptor can be reused right away:
+
+        _sockets.erase(std::remove(_sockets.begin(), _sockets.end(), socket), _sockets.end());
+        ::close(socket);
+    }
+
+    void closeAll()
+    {
+        for(int socket : _sockets)
+        {
+            ::close(socket);
+        }
+
+        _sockets.clear();
+    }
+
+protected:
+    std::mutex _mutex;
+    std::vector<int> _sockets;
+};
+
+///@endcond
+
+/**
+ * @brief Calculates the losses of multiple solutions in worker processes.
+ *
+ * Solutions are split in batches which are sent to the workers through sockets, so the loss function
+ * doesn't need to be thread safe. Workers can be local processes forked from the current one,
+ * or remote processes connected through Unix or TCP sockets which run ProcessPoolEvaluator::serve.
+ *
+ * Local workers are forked the first time losses are calculated, and each one of them keeps
+ * a copy of the loss function at that moment.
+ *
+ * Forked workers only contain the thread which forked them. If other threads are running at that moment
+ * (like the ones of a ThreadPool), the loss function must not depend on them or on locks they could hold,
+ * so it is safer to start the workers (see start) before creating other threads, or to use remote workers.
+ *
+ * Solutions and losses are converted to and from bytes with the given serializers (see Serializer).
+ * All losses must be converted to the same number of bytes, so replies of workers can be validated.
+ *
+ * This class is available in POSIX systems only.
+ */
+template<class Solution, class LossFunction, class SolutionSerializer = Serializer<Solution>,
+         class LossSerializer = Serializer<typename std::result_of<LossFunction(const Solution&)>::type>>
+class ProcessPoolEvaluator
+{
+
+public:
+    /**
+     * Evaluated candidate solution type.
+     */
+    using Candidate = Solution;
+
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+
+    /**
+     * @brief Class constructor which forks as many workers as concurrent threads are supported by the implementation.
+     */
+    ProcessPoolEvaluator() :
+        ProcessPoolEvaluator(std::thread::hardware_concurrency())
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param processes Number of worker processes to fork. It can be zero if only remote workers are used.
+     */
+    explicit ProcessPoolEvaluator(unsigned int processes) :
+        _workers(new Workers()),
+        _processes(processes)
+    {
+    }
+
+    /**
+     * @brief Returns the number of worker processes to fork.
+     */
+    unsigned int getProcesses() const noexcept
+    {
+        return _processes;
+    }
+
+    /**
+     * @brief Returns the number of workers which are still connected, including the local and the remote ones.
+     *
+     * Local workers are only counted after they have been forked (see start).
+     */
+    std::size_t getWorkersCount() const noexcept
+    {
+        std::size_t workersCount = 0;
+
+        for(int socket : _workers->sockets)
+        {
+            if(socket >= 0)
+            {
+                ++workersCount;
+            }
+        }
+
+        return workersCount;
+    }
+
+    /**
+     * @brief Forks the local workers if they have not been forked yet.
+     *
+     * It is called the first time losses are calculated, so it only needs to be called
+     * to check if the workers could be forked.
+     *
+     * @param lossFunction Loss function copied by the local workers.
+     * @return true if all local workers have been forked, otherwise false
+     * (the ones which have been forked before the failure are still used).
+     */
+    bool start(LossFunction& lossFunction)
+    {
+        Workers& workers = *_workers;
+
+        if(workers.started)
+        {
+            return workers.forked;
+        }
+
+        workers.started = true;
+        workers.forked = _fork(lossFunction);
+        return workers.forked;
+    }
+
+    /**
+     * @brief Adds a remote worker.
+     * @param socket Connected Unix or TCP socket to a process which runs ProcessPoolEvaluator::serve.
+     * This object takes its ownership.
+     */
+    void addWorker(int socket)
+    {
+        HIKE_ASSERT(socket >= 0);
+
+        _WorkerSockets& workerSockets = _WorkerSockets::get();
+        std::lock_guard<std::mutex> lock(workerSockets.getMutex());
+        workerSockets.add(socket);
+        _workers->sockets.push_back(socket);
+    }
+
+    /**
+     * @brief Calculates the losses of the given solutions.
+     * @param lossFunction Loss function used to calculate the losses.
+     * @param solutionsAndLosses Solutions to evaluate. Their losses are stored in the second member of each pair.
+     * @param cutoff Losses not lower than this value don't need to be exact (see HasCutoff).
+     */
+    template<class SolutionsAllocator>
+    void operator()(LossFunction& lossFunction,
+                    std::vector<std::pair<Solution, LossType>, SolutionsAllocator>& solutionsAndLosses,
+                    const LossType& cutoff)
+    {
+        Workers& workers = *_workers;
+        start(lossFunction);
+
+        std::vector<int>& sockets = workers.sockets;
+        std::size_t workersCount = sockets.size();
+        std::size_t solutionsCount = solutionsAndLosses.size();
+
+        // Workers reply with a loss per solution, so larger replies are rejected:
+
+        std::vector<char>& buffer = workers.buffer;
+        buffer.clear();
+        LossSerializer::write(cutoff, buffer);
+
+        std::size_t lossSize = buffer.size();
+
+        // Send a batch of solutions to each worker:
+
+        for(std::size_t workerIndex = 0; workerIndex < workersCount; ++workerIndex)
+        {
+            std::size_t begin = solutionsCount * workerIndex / workersCount;
+            std::size_t end = solutionsCount * (workerIndex + 1) / workersCount;
+            int socket = sockets[workerIndex];
+
+            if(begin < end && socket >= 0)
+            {
+                buffer.clear();
+                Serializer<std::uint64_t>::write(0, buffer);
+                Serializer<std::uint64_t>::write(end - begin, buffer);
+                LossSerializer::write(cutoff, buffer);
+
+                for(std::size_t index = begin; index < end; ++index)
+                {
+                    SolutionSerializer::write(solutionsAndLosses[index].first, buffer);
+                }
+
+                std::uint64_t payloadSize = buffer.size() - sizeof(std::uint64_t);
+                std::memcpy(buffer.data(), &payloadSize, sizeof(std::uint64_t));
+
+                if(! _send(socket, buffer.data(), buffer.size()))
+                {
+                    _close(workerIndex);
+                }
+            }
+        }
+
+        // Receive the losses from each worker, calculating them in this process if the worker has failed:
+
+        for(std::size_t workerIndex = 0; workerIndex < workersCount; ++workerIndex)
+        {
+            std::size_t begin = solutionsCount * workerIndex / workersCount;
+            std::size_t end = solutionsCount * (workerIndex + 1) / workersCount;
+
+            if(begin < end)
+            {
+                bool received = false;
+                int socket = sockets[workerIndex];
+
+                if(socket >= 0 && _receive(socket, buffer, lossSize * (end - begin)))
+                {
+                    const char* data = buffer.data();
+                    const char* dataEnd = data + buffer.size();
+                    received = true;
+
+                    for(std::size_t index = begin; index < end && received; ++index)
+                    {
+                        received = LossSerializer::read(data, dataEnd, solutionsAndLosses[index].second);
+                    }
+                }
+
+                if(! received)
+                {
+                    _close(workerIndex);
+
+                    for(std::size_t index = begin; index < end; ++index)
+                    {
+                        std::pair<Solution, LossType>& solutionAndLoss = solutionsAndLosses[index];
+                        solutionAndLoss.second = evaluateLoss(lossFunction, solutionAndLoss.first, cutoff);
+                    }
+                }
+            }
+        }
+
+        // Without workers, losses are calculated in this process:
+
+        if(! workersCount)
+        {
+            for(std::pair<Solution, LossType>& solutionAndLoss : solutionsAndLosses)
+            {
+                solutionAndLoss.second = evaluateLoss(lossFunction, solutionAndLoss.first, cutoff);
+            }
+        }
+    }
+
+    /**
+     * @brief Calculates the losses of the solutions received through the given socket until it is closed.
+     * @param socket Connected Unix or TCP socket to a ProcessPoolEvaluator.
+     * @param lossFunction Loss function used to calculate the losses.
+     */
+    static void serve(int socket, LossFunction& lossFunction)
+    {
+        std::vector<char> inputBuffer;
+        std::vector<char> outputBuffer;
+        Solution solution;
+        LossType cutoff;
+
+        while(_receive(socket, inputBuffer, std::numeric_limits<std::size_t>::max()))
+        {
+            const char* data = inputBuffer.data();
+            const char* dataEnd = data + inputBuffer.size();
+            std::uint64_t solutionsCount;
+
+            if(! Serializer<std::uint64_t>::read(data, dataEnd, solutionsCount) ||
+                    ! LossSerializer::read(data, dataEnd, cutoff))
+            {
+                return;
+            }
+
+            outputBuffer.clear();
+            Serializer<std::uint64_t>::write(0, outputBuffer);
+
+            for(std::uint64_t index = 0; index < solutionsCount; ++index)
+            {
+                if(! SolutionSerializer::read(data, dataEnd, solution))
+                {
+                    return;
+                }
+
+                LossSerializer::write(evaluateLoss(lossFunction, solution, cutoff), outputBuffer);
+            }
+
+            std::uint64_t payloadSize = outputBuffer.size() - sizeof(std::uint64_t);
+            std::memcpy(outputBuffer.data(), &payloadSize, sizeof(std::uint64_t));
+
+            if(! _send(socket, outputBuffer.data(), outputBuffer.size()))
+            {
+                return;
+            }
+        }
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    struct Workers
+    {
+        std::vector<int> sockets;
+        std::vector<pid_t> pids;
+        std::vector<char> buffer;
+        bool started = false;
+        bool forked = false;
+
+        ~Workers()
+        {
+            {
+                _WorkerSockets& workerSockets = _WorkerSockets::get();
+                std::lock_guard<std::mutex> lock(workerSockets.getMutex());
+
+                for(int socket : sockets)
+                {
+                    if(socket >= 0)
+                    {
+                        workerSockets.close(socket);
+                    }
+                }
+            }
+
+            for(pid_t pid : pids)
+            {
+                ::waitpid(pid, nullptr, 0);
+            }
+        }
+    };
+
+    std::unique_ptr<Workers> _workers;
+    unsigned int _processes;
+
+    bool _fork(LossFunction& lossFunction)
+    {
+        Workers& workers = *_workers;
+        _WorkerSockets& workerSockets = _WorkerSockets::get();
+
+        for(unsigned int index = 0; index < _processes; ++index)
+        {
+            // The registry is locked until the worker socket is closed in this process,
+            // so workers forked by other threads don't inherit it:
+
+            std::unique_lock<std::mutex> lock(workerSockets.getMutex());
+            int sockets[2];
+
+            if(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+            {
+                return false;
+            }
+
+            pid_t pid = ::fork();
+
+            if(pid == 0)
+            {
+                // Worker process, which closes the inherited sockets of every evaluator:
+
+                ::close(sockets[0]);
+                workerSockets.closeAll();
+                lock.unlock();
+
+                serve(sockets[1], lossFunction);
+                ::close(sockets[1]);
+                ::_exit(0);
+            }
+
+            ::close(sockets[1]);
+
+            if(pid < 0)
+            {
+                ::close(sockets[0]);
+                return false;
+            }
+
+            workerSockets.add(sockets[0]);
+            workers.sockets.push_back(sockets[0]);
+            workers.pids.push_back(pid);
+        }
+
+        return true;
+    }
+
+    void _close(std::size_t workerIndex)
+    {
+        int& socket = _workers->sockets[workerIndex];
+
+        if(socket >= 0)
+        {
+            _WorkerSockets& workerSockets = _WorkerSockets::get();
+            std::lock_guard<std::mutex> lock(workerSockets.getMutex());
+            workerSockets.close(socket);
+            socket = -1;
+        }
+    }
+
+    static bool _send(int socket, const char* data, std::size_t size)
+    {
+        #ifdef MSG_NOSIGNAL
+            const int flags = MSG_NOSIGNAL;
+        #else
+            const int flags = 0;
+        #endif
+
+        while(size)
+        {
+            ssize_t sentBytes = ::send(socket, data, size, flags);
+
+            if(sentBytes < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            data += sentBytes;
+            size -= std::size_t(sentBytes);
+        }
+
+        return true;
+    }
+
+    static bool _receive(int socket, char* data, std::size_t size)
+    {
+        while(size)
+        {
+            ssize_t receivedBytes = ::recv(socket, data, size, 0);
+
+            if(receivedBytes <= 0)
+            {
+                if(receivedBytes < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            data += receivedBytes;
+            size -= std::size_t(receivedBytes);
+        }
+
+        return true;
+    }
+
+    static bool _receive(int socket, std::vector<char>& buffer, std::size_t maxPayloadSize)
+    {
+        std::uint64_t payloadSize;
+
+        if(! _receive(socket, reinterpret_cast<char*>(&payloadSize), sizeof(std::uint64_t)) ||
+                payloadSize > maxPayloadSize)
+        {
+            return false;
+        }
+
+        buffer.resize(std::size_t(payloadSize));
+        return _receive(socket, buffer.data(), buffer.size());
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
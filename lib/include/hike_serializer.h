@@ -0,0 +1,123 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_SERIALIZER_H
+#define HIKE_SERIALIZER_H
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <type_traits>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Converts values to and from bytes.
+ *
+ * It supports trivially copyable types (like std::array<int, N>) and std::vector of trivially copyable types.
+ * Other types can be supported by specializing this class with the same interface.
+ */
+template<class Type, class Enable = void>
+class Serializer
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "Type is not trivially copyable");
+
+public:
+    /**
+     * @brief Appends the bytes of the given value to the given buffer.
+     */
+    static void write(const Type& value, std::vector<char>& buffer)
+    {
+        const char* valueData = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), valueData, valueData + sizeof(Type));
+    }
+
+    /**
+     * @brief Reads a value from the given bytes range.
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @param value Output value.
+     * @return true if the value has been read successfully, otherwise false.
+     */
+    static bool read(const char*& data, const char* dataEnd, Type& value)
+    {
+        if(std::size_t(dataEnd - data) < sizeof(Type))
+        {
+            return false;
+        }
+
+        std::memcpy(&value, data, sizeof(Type));
+        data += sizeof(Type);
+        return true;
+    }
+};
+
+/**
+ * @brief Converts vectors of trivially copyable values to and from bytes.
+ */
+template<class Type, class Allocator>
+class Serializer<std::vector<Type, Allocator>>
+{
+    static_assert(std::is_trivially_copyable<Type>::value, "Type is not trivially copyable");
+
+public:
+    /**
+     * @brief Appends the bytes of the given value to the given buffer.
+     */
+    static void write(const std::vector<Type, Allocator>& value, std::vector<char>& buffer)
+    {
+        Serializer<std::uint64_t>::write(value.size(), buffer);
+
+        const char* valueData = reinterpret_cast<const char*>(value.data());
+        buffer.insert(buffer.end(), valueData, valueData + (value.size() * sizeof(Type)));
+    }
+
+    /**
+     * @brief Reads a value from the given bytes range.
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @param value Output value.
+     * @return true if the value has been read successfully, otherwise false.
+     */
+    static bool read(const char*& data, const char* dataEnd, std::vector<Type, Allocator>& value)
+    {
+        std::uint64_t size;
+
+        if(! Serializer<std::uint64_t>::read(data, dataEnd, size) || std::uint64_t(dataEnd - data) / sizeof(Type) < size)
+        {
+            return false;
+        }
+
+        value.resize(std::size_t(size));
+
+        if(size)
+        {
+            std::memcpy(value.data(), data, std::size_t(size) * sizeof(Type));
+            data += std::size_t(size) * sizeof(Type);
+        }
+
+        return true;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,208 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_SOLUTION_HASH_H
+#define HIKE_SOLUTION_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+namespace hike
+{
+
+///@cond INTERNAL
+
+class _ParamsHasher
+{
+
+public:
+    template<class Value>
+    static std::uint64_t hash(const Value* params, std::size_t paramsCount) noexcept
+    {
+        // Four independent lanes (as in xxHash64), so consecutive parameters are mixed in parallel:
+
+        std::uint64_t lane0 = _prime1 + _prime2;
+        std::uint64_t lane1 = _prime2;
+        std::uint64_t lane2 = 0;
+        std::uint64_t lane3 = std::uint64_t(0) - _prime1;
+        std::size_t index = 0;
+
+        for(; index + 4 <= paramsCount; index += 4)
+        {
+            lane0 = _round(lane0, word(params[index]));
+            lane1 = _round(lane1, word(params[index + 1]));
+            lane2 = _round(lane2, word(params[index + 2]));
+            lane3 = _round(lane3, word(params[index + 3]));
+        }
+
+        std::uint64_t result = _rotl(lane0, 1) + _rotl(lane1, 7) + _rotl(lane2, 12) + _rotl(lane3, 18);
+        result += std::uint64_t(paramsCount);
+
+        for(; index < paramsCount; ++index)
+        {
+            result ^= _round(0, word(params[index]));
+            result = _rotl(result, 27) * _prime1 + _prime4;
+        }
+
+        result ^= result >> 33;
+        result *= _prime2;
+        result ^= result >> 29;
+        result *= _prime3;
+        result ^= result >> 32;
+        return result;
+    }
+
+    template<class Value>
+    static typename std::enable_if<std::is_integral<Value>::value, std::uint64_t>::type word(Value value) noexcept
+    {
+        return std::uint64_t(value);
+    }
+
+    template<class Value>
+    static typename std::enable_if<std::is_floating_point<Value>::value, std::uint64_t>::type word(
+            Value value) noexcept
+    {
+        // Equal values must have equal hashes, so -0.0 is hashed as 0.0 and all NaNs are hashed the same way:
+
+        if(value == 0)
+        {
+            return 0;
+        }
+
+        if(value != value)
+        {
+            return 0x7FF8000000000000ULL;
+        }
+
+        return _floatWord(value);
+    }
+
+protected:
+    static constexpr std::uint64_t _prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t _prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t _prime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t _prime4 = 0x85EBCA77C2B2AE63ULL;
+
+    static std::uint64_t _rotl(std::uint64_t value, int bits) noexcept
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static std::uint64_t _round(std::uint64_t lane, std::uint64_t value) noexcept
+    {
+        lane += value * _prime2;
+        lane = _rotl(lane, 31);
+        return lane * _prime1;
+    }
+
+    static std::uint64_t _floatWord(float value) noexcept
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static std::uint64_t _floatWord(double value) noexcept
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    static std::uint64_t _floatWord(long double value) noexcept
+    {
+        return _floatWord(double(value));
+    }
+};
+
+template<class Solution>
+class _IsArithmeticParams
+{
+
+protected:
+    template<class SolutionType>
+    static auto _test(int) -> decltype(std::declval<const SolutionType&>().size(), std::integral_constant<bool,
+            std::is_arithmetic<typename std::remove_pointer<decltype(
+                std::declval<const SolutionType&>().data())>::type>::value>());
+
+    template<class SolutionType>
+    static std::false_type _test(...);
+
+public:
+    static constexpr bool value = decltype(_test<Solution>(0))::value;
+};
+
+///@endcond
+
+/**
+ * @brief Returns a hash of the given array of arithmetic parameters.
+ *
+ * Floating point parameters which are equal have the same hash (0.0 and -0.0 for example), and all NaNs too.
+ */
+template<class Value>
+std::size_t hashParams(const Value* params, std::size_t paramsCount) noexcept
+{
+    static_assert(std::is_arithmetic<Value>::value, "Parameters must be arithmetic");
+
+    return std::size_t(_ParamsHasher::hash(params, paramsCount));
+}
+
+/**
+ * @brief Default solution hash used by loss caches (see CachedLossFunction and TSCachedLossFunction).
+ *
+ * Solutions which are contiguous containers of arithmetic parameters with data() and size() methods
+ * (as std::array and std::vector) are hashed with hashParams. Other solutions are hashed with std::hash,
+ * so it must be specialized for them.
+ */
+template<class Solution, class Enable = void>
+class SolutionHash
+{
+
+public:
+    /**
+     * @brief Returns the hash of the given solution.
+     */
+    std::size_t operator()(const Solution& solution) const
+    {
+        return std::hash<Solution>()(solution);
+    }
+};
+
+///@cond INTERNAL
+
+template<class Solution>
+class SolutionHash<Solution, typename std::enable_if<_IsArithmeticParams<Solution>::value>::type>
+{
+
+public:
+    std::size_t operator()(const Solution& solution) const noexcept
+    {
+        return hashParams(solution.data(), solution.size());
+    }
+};
+
+///@endcond
+
+}
+
+#endif
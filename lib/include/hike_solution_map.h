@@ -0,0 +1,156 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_SOLUTION_MAP_H
+#define HIKE_SOLUTION_MAP_H
+
+#include <memory>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+namespace hike
+{
+
+///@cond INTERNAL
+
+struct _IdentityHash
+{
+    std::size_t operator()(std::size_t hash) const noexcept
+    {
+        return hash;
+    }
+};
+
+/**
+ * Map from solutions to values used by the caches.
+ *
+ * Entries are keyed by the solution hash, so solutions whose hash is already known (see HashedSolution)
+ * can be looked up and inserted without hashing them again.
+ */
+template<class Solution, class Value, class SolutionHash, class Allocator>
+class _SolutionMap
+{
+
+public:
+    struct Entry
+    {
+        Solution solution;
+        Value value;
+    };
+
+    using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<
+        std::pair<const std::size_t, Entry>>;
+
+    using Map = std::unordered_multimap<std::size_t, Entry, _IdentityHash, std::equal_to<std::size_t>, MapAllocator>;
+    using iterator = typename Map::iterator;
+    using const_iterator = typename Map::const_iterator;
+
+    _SolutionMap() = default;
+
+    explicit _SolutionMap(const Allocator& allocator) :
+        _map(0, _IdentityHash(), std::equal_to<std::size_t>(), MapAllocator(allocator))
+    {
+    }
+
+    std::size_t hash(const Solution& solution) const
+    {
+        return _solutionHash(solution);
+    }
+
+    iterator find(const Solution& solution, std::size_t hash)
+    {
+        auto range = _map.equal_range(hash);
+
+        for(auto it = range.first; it != range.second; ++it)
+        {
+            if(it->second.solution == solution)
+            {
+                return it;
+            }
+        }
+
+        return _map.end();
+    }
+
+    const_iterator find(const Solution& solution, std::size_t hash) const
+    {
+        auto range = _map.equal_range(hash);
+
+        for(auto it = range.first; it != range.second; ++it)
+        {
+            if(it->second.solution == solution)
+            {
+                return it;
+            }
+        }
+
+        return _map.end();
+    }
+
+    iterator insert(const Solution& solution, std::size_t hash, const Value& value)
+    {
+        return _map.insert(std::make_pair(hash, Entry{ solution, value }));
+    }
+
+    iterator erase(iterator it)
+    {
+        return _map.erase(it);
+    }
+
+    iterator begin() noexcept
+    {
+        return _map.begin();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return _map.begin();
+    }
+
+    iterator end() noexcept
+    {
+        return _map.end();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return _map.end();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _map.size();
+    }
+
+    std::size_t bucket_count() const noexcept
+    {
+        return _map.bucket_count();
+    }
+
+protected:
+    Map _map;
+    SolutionHash _solutionHash;
+};
+
+///@endcond
+
+}
+
+#endif
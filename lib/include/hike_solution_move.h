@@ -0,0 +1,178 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_SOLUTION_MOVE_H
+#define HIKE_SOLUTION_MOVE_H
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Candidate solution represented as a base solution plus the parameters which differ from it.
+ *
+ * Loss functions can calculate the loss of a candidate solution from its base solution and its changed parameters
+ * without copying the whole solution (see HasMoveLoss).
+ *
+ * A move only references its base solution and changed parameters,
+ * so it must not be used after the local search which provided it returns.
+ */
+template<class Solution>
+class SolutionMove
+{
+
+public:
+    /**
+     * Solution parameter type.
+     */
+    using Param = typename std::decay<decltype(std::declval<const Solution&>()[0])>::type;
+
+    /**
+     * @brief Solution parameter which differs from the base solution.
+     */
+    struct ParamChange
+    {
+        /**
+         * @brief Index of the parameter in the solution.
+         */
+        std::size_t paramIndex;
+
+        /**
+         * @brief Parameter value in the candidate solution.
+         */
+        Param param;
+    };
+
+    /**
+     * @brief Class constructor.
+     * @param baseSolution Solution from which the candidate solution is generated.
+     * @param paramChanges Storage of the changed parameters.
+     * @param firstParamChange Index of the first changed parameter in the storage.
+     * @param paramChangesCount Number of changed parameters.
+     */
+    SolutionMove(const Solution& baseSolution, const std::vector<ParamChange>& paramChanges,
+                 std::size_t firstParamChange, std::size_t paramChangesCount) noexcept :
+        _baseSolution(&baseSolution),
+        _paramChanges(&paramChanges),
+        _firstParamChange(firstParamChange),
+        _paramChangesCount(paramChangesCount)
+    {
+    }
+
+    /**
+     * @brief Returns the solution from which the candidate solution is generated.
+     */
+    const Solution& getBaseSolution() const noexcept
+    {
+        return *_baseSolution;
+    }
+
+    /**
+     * @brief Returns the number of parameters which differ from the base solution.
+     */
+    std::size_t size() const noexcept
+    {
+        return _paramChangesCount;
+    }
+
+    /**
+     * @brief Returns the changed parameter with the given index, sorted by parameter index.
+     */
+    const ParamChange& operator[](std::size_t index) const noexcept
+    {
+        HIKE_ASSERT(index < _paramChangesCount);
+
+        return (*_paramChanges)[_firstParamChange + index];
+    }
+
+    /**
+     * @brief Returns an iterator to the first changed parameter.
+     */
+    const ParamChange* begin() const noexcept
+    {
+        return _paramChanges->data() + _firstParamChange;
+    }
+
+    /**
+     * @brief Returns an iterator past the last changed parameter.
+     */
+    const ParamChange* end() const noexcept
+    {
+        return begin() + _paramChangesCount;
+    }
+
+    /**
+     * @brief Returns the parameter of the candidate solution with the given index.
+     *
+     * Its cost is linear in the number of changed parameters.
+     */
+    Param getParam(std::size_t paramIndex) const
+    {
+        for(const ParamChange& paramChange : *this)
+        {
+            if(paramChange.paramIndex == paramIndex)
+            {
+                return paramChange.param;
+            }
+        }
+
+        return (*_baseSolution)[paramIndex];
+    }
+
+    /**
+     * @brief Sets the changed parameters in the given solution.
+     *
+     * If the given solution is equal to the base one, it becomes equal to the candidate solution.
+     */
+    void apply(Solution& solution) const
+    {
+        for(const ParamChange& paramChange : *this)
+        {
+            solution[paramChange.paramIndex] = paramChange.param;
+        }
+    }
+
+    /**
+     * @brief Returns a copy of the candidate solution.
+     */
+    Solution getSolution() const
+    {
+        Solution solution = *_baseSolution;
+        apply(solution);
+        return solution;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    const Solution* _baseSolution;
+    const std::vector<ParamChange>* _paramChanges;
+    std::size_t _firstParamChange;
+    std::size_t _paramChangesCount;
+
+    ///@endcond
+};
+
+}
+
+#endif
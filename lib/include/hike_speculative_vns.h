@@ -0,0 +1,359 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+
+#ifndef HIKE_SPECULATIVE_VNS_H
+#define HIKE_SPECULATIVE_VNS_H
+
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include "hike_thread_pool.h"
+#include "hike_neighborhood_schedules.h"
+
+namespace hike
+{
+
+/**
+ * @brief Variable neighborhood search which applies the local searches of multiple neighborhoods in parallel.
+ *
+ * When the current neighborhood fails to improve the best solution, sequential VNS moves to the next one.
+ * This class predicts that sequence of failures with a copy of the neighborhood schedule state and applies
+ * the local searches of the next neighborhoods concurrently from the same best solution.
+ * The result of the lowest neighborhood which improves it is taken, and the local searches of higher neighborhoods
+ * which have not been started yet are cancelled.
+ *
+ * The optimization results are the same as the ones of the given VNS object, as long as its local search
+ * doesn't keep state between calls (as move ordering does) and it doesn't depend on the order of evaluations.
+ *
+ * Each thread uses its own copy of the given VNS object (and of its local search and loss function),
+ * so it must be copyable. The improved solution callback of the VNS object is called from the calling thread only.
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ */
+template<class Solution, class VNS>
+class SpeculativeVNS
+{
+
+public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename VNS::LossType;
+
+    /**
+     * Optimization process state, which allows to split it in multiple steps.
+     */
+    using State = typename VNS::State;
+
+    /**
+     * @brief Class constructor which uses the number of concurrent threads supported by the implementation.
+     * @param vns VNS object whose local searches are applied in parallel.
+     */
+    template<class VNSType>
+    explicit SpeculativeVNS(VNSType&& vns) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<SearchTask>())
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param vns VNS object whose local searches are applied in parallel.
+     * @param threads Number of threads used to apply local searches,
+     * which is also the number of neighborhoods searched at the same time.
+     */
+    template<class VNSType>
+    SpeculativeVNS(VNSType&& vns, unsigned int threads) :
+        _vns(std::forward<VNSType>(vns)),
+        _threadPool(new ThreadPool<SearchTask>(threads))
+    {
+    }
+
+    /**
+     * @brief Returns the VNS object whose local searches are applied in parallel.
+     */
+    const VNS& getVNS() const noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the VNS object whose local searches are applied in parallel.
+     *
+     * If it is modified after an optimization, resetVNSCopies must be called.
+     */
+    VNS& getVNS() noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::getSpinCount).
+     */
+    int getSpinCount() const noexcept
+    {
+        return _threadPool->getSpinCount();
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::setSpinCount).
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        _threadPool->setSpinCount(spinCount);
+    }
+
+    /**
+     * @brief Indicates if the calling thread applies pending local searches too instead of waiting for the managed threads
+     * (see ThreadPool::isCallerParticipationEnabled).
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _threadPool->isCallerParticipationEnabled();
+    }
+
+    /**
+     * @brief Specifies if the calling thread applies pending local searches too instead of waiting for the managed threads
+     * (disabled by default, see ThreadPool::setCallerParticipationEnabled).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _threadPool->setCallerParticipationEnabled(enabled);
+    }
+
+    /**
+     * @brief Destroys the VNS object copies of each thread, so they are created again on the next optimization.
+     */
+    void resetVNSCopies()
+    {
+        _slots.clear();
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution)
+    {
+        bool optimized;
+
+        return optimize(std::forward<SolutionType>(solution), optimized);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @param optimized Output parameter which indicates if the input solution has been optimized or not.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution, bool& optimized)
+    {
+        State state = createState(std::forward<SolutionType>(solution));
+
+        while(! iterate(state, std::numeric_limits<int>::max()))
+        {
+        }
+
+        optimized = state.optimized;
+        return std::move(state.solution);
+    }
+
+    /**
+     * @brief Creates the initial state of the optimization of the given solution.
+     * @param solution The solution to optimize.
+     * @return The initial optimization state.
+     */
+    template<class SolutionType>
+    State createState(SolutionType&& solution)
+    {
+        return _vns.createState(std::forward<SolutionType>(solution));
+    }
+
+    /**
+     * @brief Creates the initial state of the optimization of the given solution.
+     * @param solution The solution to optimize.
+     * @param loss Loss of the solution to optimize.
+     * @return The initial optimization state.
+     */
+    template<class SolutionType>
+    State createState(SolutionType&& solution, const LossType& loss)
+    {
+        return _vns.createState(std::forward<SolutionType>(solution), loss);
+    }
+
+    /**
+     * @brief Continues the optimization process with the given state.
+     * @param state Optimization state to update.
+     * @param maxIterations Maximum number of local search results to apply.
+     * @return true if the optimization process has finished, otherwise false.
+     */
+    bool iterate(State& state, int maxIterations)
+    {
+        int kmax = _vns.getKmax();
+        _updateSlots();
+
+        for(int iteration = 0; iteration < maxIterations && state.k <= kmax; )
+        {
+            // Predict the next neighborhoods assuming that the local searches fail:
+
+            auto scheduleState = state.scheduleState;
+            std::size_t maxSlotsCount = std::size_t(maxIterations - iteration);
+            std::size_t slotsCount = 0;
+            int k = state.k;
+
+            while(slotsCount < _slots.size() && slotsCount < maxSlotsCount && k <= kmax)
+            {
+                _slots[slotsCount].k = k;
+                ++slotsCount;
+                k = _vns.getNeighborhoodSchedule().next(scheduleState, NeighborhoodResult{ k, false, 0, 0 }, kmax);
+            }
+
+            _solution = &state.solution;
+            _loss = &state.loss;
+            _firstImprovedSlotIndex = slotsCount;
+
+            for(std::size_t slotIndex = 0; slotIndex < slotsCount; ++slotIndex)
+            {
+                _threadPool->add(SearchTask(*this, slotIndex));
+            }
+
+            _threadPool->join();
+
+            // Apply the results in order, as sequential VNS would do, until the best solution is improved
+            // or the schedule diverges from the predicted neighborhoods:
+
+            for(std::size_t slotIndex = 0; slotIndex < slotsCount; ++slotIndex)
+            {
+                Slot& slot = _slots[slotIndex];
+
+                if(! slot.searched || slot.k != state.k)
+                {
+                    break;
+                }
+
+                _vns.updateState(state, slot.result, slot.candidate, slot.loss);
+                ++iteration;
+
+                if(slot.result.improved || state.k > kmax)
+                {
+                    break;
+                }
+            }
+        }
+
+        return state.k > kmax;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    class SearchTask
+    {
+
+    public:
+        SearchTask(SpeculativeVNS& speculativeVNS, std::size_t slotIndex) :
+            _speculativeVNS(speculativeVNS),
+            _slotIndex(slotIndex)
+        {
+        }
+
+        void operator()()
+        {
+            _speculativeVNS._search(_slotIndex);
+        }
+
+    protected:
+        SpeculativeVNS& _speculativeVNS;
+        std::size_t _slotIndex;
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<VNS> vns;
+        Solution candidate;
+        LossType loss;
+        NeighborhoodResult result;
+        int k;
+        bool searched;
+    };
+
+    VNS _vns;
+    std::unique_ptr<ThreadPool<SearchTask>> _threadPool;
+    std::vector<Slot> _slots;
+    const Solution* _solution;
+    const LossType* _loss;
+    std::atomic<std::size_t> _firstImprovedSlotIndex;
+
+    void _updateSlots()
+    {
+        // The first slot uses the original VNS object:
+
+        if(_slots.empty())
+        {
+            std::size_t slotsCount = _threadPool->getThreadsCount();
+            _slots.resize(slotsCount);
+
+            for(std::size_t slotIndex = 1; slotIndex < slotsCount; ++slotIndex)
+            {
+                _slots[slotIndex].vns.reset(new VNS(_vns));
+            }
+        }
+    }
+
+    void _search(std::size_t slotIndex)
+    {
+        Slot& slot = _slots[slotIndex];
+        slot.searched = false;
+
+        // Neighborhoods higher than an improving one are not needed:
+        if(_firstImprovedSlotIndex.load(std::memory_order_acquire) < slotIndex)
+        {
+            return;
+        }
+
+        VNS& vns = slotIndex ? *slot.vns : _vns;
+        slot.result = vns.searchNeighborhood(*_solution, *_loss, slot.k, slot.candidate, slot.loss);
+        slot.searched = true;
+
+        if(slot.result.improved)
+        {
+            std::size_t firstImprovedSlotIndex = _firstImprovedSlotIndex.load(std::memory_order_relaxed);
+
+            while(slotIndex < firstImprovedSlotIndex &&
+                  ! _firstImprovedSlotIndex.compare_exchange_weak(firstImprovedSlotIndex, slotIndex,
+                                                                  std::memory_order_acq_rel))
+            {
+            }
+        }
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
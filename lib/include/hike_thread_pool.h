@@ -23,15 +23,101 @@
 #include <deque>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
-#include "hike_common.h"
+#include "hike_numa_topology.h"
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
 
 namespace hike
 {
 
+/**
+ * @brief Provides information about the ThreadPool worker thread which calls its methods.
+ */
+class ThreadPoolWorker
+{
+
+public:
+    /**
+     * @brief Returns the index of the calling worker thread in its ThreadPool,
+     * or -1 if it is not called from a ThreadPool worker thread.
+     */
+    static int getIndex() noexcept
+    {
+        return _placement().index;
+    }
+
+    /**
+     * @brief Returns the NUMA node of the calling worker thread (see ThreadPlacement),
+     * or -1 if it is not called from a ThreadPool worker thread.
+     */
+    static int getNode() noexcept
+    {
+        return _placement().node;
+    }
+
+    /**
+     * @brief Indicates if the calling worker thread has been pinned to the CPU of its ThreadPlacement.
+     *
+     * It returns false if it is not called from a ThreadPool worker thread, if its placement doesn't specify a CPU
+     * or if the thread could not be pinned to it (for example, because the CPU is not available to the process).
+     */
+    static bool isPinned() noexcept
+    {
+        return _placement().pinned;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    template<class Task>
+    friend class ThreadPool;
+
+    struct Placement
+    {
+        int index;
+        int node;
+        bool pinned;
+    };
+
+    static Placement& _placement() noexcept
+    {
+        static thread_local Placement placement{ -1, -1, false };
+        return placement;
+    }
+
+    static void _setup(int index, const ThreadPlacement& threadPlacement)
+    {
+        Placement& placement = _placement();
+        placement.index = index;
+        placement.node = threadPlacement.node;
+
+        #ifdef __linux__
+            if(threadPlacement.cpu >= 0 && threadPlacement.cpu < CPU_SETSIZE)
+            {
+                cpu_set_t cpuSet;
+                CPU_ZERO(&cpuSet);
+                CPU_SET(threadPlacement.cpu, &cpuSet);
+                placement.pinned = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+            }
+        #endif
+    }
+
+    ///@endcond
+};
+
 /**
  * @brief Basic thread pool.
  *
+ * Idle threads spin for a while before waiting on a condition variable,
+ * so tasks added shortly after the previous ones are started without wake-up latency.
+ *
+ * The thread which calls join() can also complete pending tasks instead of waiting for them.
+ *
  * Based on https://stackoverflow.com/questions/26516683/reusing-thread-in-loop-c
  */
 template<class Task>
@@ -52,24 +138,46 @@ public:
      * @param threads Number of threads to manage.
      */
     explicit ThreadPool(unsigned int threads) :
+        ThreadPool(std::vector<ThreadPlacement>(threads))
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param placements Where each managed thread must run. Pinning threads to CPUs is supported in Linux only.
+     */
+    explicit ThreadPool(const std::vector<ThreadPlacement>& placements) :
         _exit(false),
-        _pendingTasks(0)
+        _sleepingThreads(0),
+        _queuedTasks(0),
+        _pendingTasks(0),
+        _spinCount(std::thread::hardware_concurrency() > 1 ? 1000 : 0),
+        _callerParticipationEnabled(false)
     {
+        std::size_t threads = placements.size();
         HIKE_ASSERT(threads > 0);
 
         _threads.reserve(threads);
 
-        for(unsigned int index = 0; index < threads; ++index)
+        for(std::size_t index = 0; index < threads; ++index)
         {
-            _threads.emplace_back([this]
+            ThreadPlacement placement = placements[index];
+
+            _threads.emplace_back([this, index, placement]
             {
+                ThreadPoolWorker::_setup(int(index), placement);
+
                 while(true)
                 {
+                    _spin([this]{ return _queuedTasks.load(std::memory_order_relaxed) > 0; });
+
                     std::unique_lock<std::mutex> lock(_mutex);
 
                     while(! _exit && _tasks.empty())
                     {
+                        ++_sleepingThreads;
                         _condition.wait(lock);
+                        --_sleepingThreads;
                     }
 
                     if(_tasks.empty())
@@ -77,20 +185,7 @@ public:
                         return;
                     }
 
-                    Task task = std::move(_tasks[0]);
-                    _tasks.pop_front();
-                    lock.unlock();
-                    task();
-
-                    std::unique_lock<std::mutex> pendingTasksLock(_pendingTasksMutex);
-
-                    --_pendingTasks;
-
-                    if(! _pendingTasks)
-                    {
-                        pendingTasksLock.unlock();
-                        _pendingTasksCondition.notify_one();
-                    }
+                    _runTask(lock);
                 }
             });
         }
@@ -114,20 +209,72 @@ public:
         }
     }
 
+    /**
+     * @brief Returns the number of managed threads.
+     */
+    std::size_t getThreadsCount() const noexcept
+    {
+        return _threads.size();
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable.
+     */
+    int getSpinCount() const noexcept
+    {
+        return _spinCount;
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable.
+     *
+     * By default it is 1000 if the implementation supports multiple concurrent threads, and 0 otherwise.
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        HIKE_ASSERT(spinCount >= 0);
+
+        _spinCount = spinCount;
+    }
+
+    /**
+     * @brief Indicates if the thread which calls join() completes pending tasks instead of waiting for them.
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _callerParticipationEnabled;
+    }
+
+    /**
+     * @brief Specifies if the thread which calls join() completes pending tasks instead of waiting for them
+     * (disabled by default, so tasks only run in the managed threads).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _callerParticipationEnabled = enabled;
+    }
+
     /**
      * @brief Add a task which must be completed by a managed thread.
      */
     template<class TaskType>
     void add(TaskType&& task)
     {
-        std::unique_lock<std::mutex> lock(_mutex);
+        bool notify;
 
-        _tasks.emplace_back(std::forward<TaskType>(task));
-        _condition.notify_one();
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
 
-        std::unique_lock<std::mutex> pendingTasksLock(_pendingTasksMutex);
+            _tasks.emplace_back(std::forward<TaskType>(task));
+            _pendingTasks.fetch_add(1, std::memory_order_relaxed);
+            _queuedTasks.fetch_add(1, std::memory_order_relaxed);
+            notify = _sleepingThreads > 0;
+        }
 
-        ++_pendingTasks;
+        if(notify)
+        {
+            _condition.notify_one();
+        }
     }
 
     /**
@@ -135,9 +282,37 @@ public:
      */
     void join()
     {
-        std::unique_lock<std::mutex> pendingTasksLock(_pendingTasksMutex);
+        while(_pendingTasks.load(std::memory_order_acquire))
+        {
+            if(_callerParticipationEnabled)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                if(! _tasks.empty())
+                {
+                    _runTask(lock);
+                    continue;
+                }
+            }
+
+            bool callerParticipation = _callerParticipationEnabled;
+
+            if(_spin([this, callerParticipation]
+            {
+                return ! _pendingTasks.load(std::memory_order_acquire) ||
+                        (callerParticipation && _queuedTasks.load(std::memory_order_relaxed) > 0);
+            }))
+            {
+                continue;
+            }
 
-        _pendingTasksCondition.wait(pendingTasksLock, [this]{ return ! _pendingTasks; });
+            std::unique_lock<std::mutex> pendingTasksLock(_pendingTasksMutex);
+
+            _pendingTasksCondition.wait(pendingTasksLock, [this]
+            {
+                return ! _pendingTasks.load(std::memory_order_acquire);
+            });
+        }
     }
 
 protected:
@@ -148,10 +323,50 @@ protected:
     std::deque<Task> _tasks;
     std::vector<std::thread> _threads;
     bool _exit;
+    int _sleepingThreads;
+    std::atomic<int> _queuedTasks;
 
     std::mutex _pendingTasksMutex;
     std::condition_variable _pendingTasksCondition;
-    int _pendingTasks;
+    std::atomic<int> _pendingTasks;
+
+    std::atomic<int> _spinCount;
+    bool _callerParticipationEnabled;
+
+    template<class Predicate>
+    bool _spin(const Predicate& predicate) const
+    {
+        for(int spin = 0, spinCount = _spinCount.load(std::memory_order_relaxed); spin < spinCount; ++spin)
+        {
+            if(predicate())
+            {
+                return true;
+            }
+
+            HIKE_CPU_PAUSE();
+        }
+
+        return false;
+    }
+
+    void _runTask(std::unique_lock<std::mutex>& lock)
+    {
+        Task task = std::move(_tasks[0]);
+        _tasks.pop_front();
+        _queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        lock.unlock();
+        task();
+
+        if(_pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Lock the mutex before notifying so a joining thread can't miss the notification:
+            {
+                std::unique_lock<std::mutex> pendingTasksLock(_pendingTasksMutex);
+            }
+
+            _pendingTasksCondition.notify_one();
+        }
+    }
 
     ///@endcond
 };
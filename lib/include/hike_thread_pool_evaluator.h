@@ -0,0 +1,519 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_THREAD_POOL_EVALUATOR_H
+#define HIKE_THREAD_POOL_EVALUATOR_H
+
+#include <cmath>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <condition_variable>
+#include "hike_loss_function_traits.h"
+#include "hike_thread_pool.h"
+
+namespace hike
+{
+
+///@cond INTERNAL
+
+template<class Candidate>
+class _BatchCandidates
+{
+
+public:
+    Candidate store(Candidate& candidate)
+    {
+        return std::move(candidate);
+    }
+
+    void restore(Candidate& candidate, Candidate& batchCandidate)
+    {
+        // Moving the candidate back keeps its memory in the caller:
+
+        candidate = std::move(batchCandidate);
+    }
+};
+
+template<class Solution>
+class _BatchCandidates<SolutionMove<Solution>>
+{
+
+public:
+    _BatchCandidates() :
+        _lastBaseSolution(nullptr)
+    {
+    }
+
+    SolutionMove<Solution> store(const SolutionMove<Solution>& move)
+    {
+        // Moves point to data owned by the caller, which can change while stragglers are evaluated:
+
+        if(&move.getBaseSolution() != _lastBaseSolution)
+        {
+            _baseSolutions.push_back(move.getBaseSolution());
+            _lastBaseSolution = &move.getBaseSolution();
+        }
+
+        std::size_t firstParamChange = _paramChanges.size();
+        _paramChanges.insert(_paramChanges.end(), move.begin(), move.end());
+        return SolutionMove<Solution>(_baseSolutions.back(), _paramChanges, firstParamChange, move.size());
+    }
+
+    void restore(SolutionMove<Solution>&, SolutionMove<Solution>&)
+    {
+    }
+
+protected:
+    std::deque<Solution> _baseSolutions;
+    std::vector<typename SolutionMove<Solution>::ParamChange> _paramChanges;
+    const Solution* _lastBaseSolution;
+};
+
+///@endcond
+
+/**
+ * @brief Calculates the losses of multiple solutions in the threads of a ThreadPool.
+ *
+ * Please note than the given loss function must be thread safe,
+ * unless loss function clones are enabled (see setLossFunctionClonesEnabled).
+ *
+ * Evaluated solutions can also be candidate solutions represented as moves (see SolutionMove).
+ *
+ * By default all losses are calculated before returning. With a deadline or a quantile cutoff,
+ * the evaluation returns early and slow candidates (stragglers) get the cutoff loss, so they can't improve
+ * the best solution. Stragglers which have not been started are cancelled, and the running ones are finished
+ * in the background (if the loss function is a TSCachedLossFunction, their losses are stored in its cache).
+ */
+template<class Solution, class LossFunction>
+class ThreadPoolEvaluator
+{
+
+public:
+    /**
+     * Evaluated candidate solution type.
+     */
+    using Candidate = Solution;
+
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename std::result_of<LossFunction(const Solution&)>::type;
+
+    /**
+     * @brief Class constructor which uses the number of concurrent threads supported by the implementation.
+     */
+    ThreadPoolEvaluator() :
+        _threadPool(new ThreadPool<LossTask>()),
+        _clonedLossFunction(nullptr),
+        _lossFunctionClonesEnabled(false),
+        _deadline(0),
+        _quantile(0),
+        _quantileFactor(1)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param threads Number of threads used to calculate losses.
+     */
+    explicit ThreadPoolEvaluator(unsigned int threads) :
+        _threadPool(new ThreadPool<LossTask>(threads)),
+        _clonedLossFunction(nullptr),
+        _lossFunctionClonesEnabled(false),
+        _deadline(0),
+        _quantile(0),
+        _quantileFactor(1)
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param placements Where each thread used to calculate losses must run (see NumaTopology::getPlacements).
+     */
+    explicit ThreadPoolEvaluator(const std::vector<ThreadPlacement>& placements) :
+        _threadPool(new ThreadPool<LossTask>(placements)),
+        _clonedLossFunction(nullptr),
+        _lossFunctionClonesEnabled(false),
+        _deadline(0),
+        _quantile(0),
+        _quantileFactor(1)
+    {
+    }
+
+    /**
+     * @brief Returns how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::getSpinCount).
+     */
+    int getSpinCount() const noexcept
+    {
+        return _threadPool->getSpinCount();
+    }
+
+    /**
+     * @brief Specifies how many times idle threads check for new tasks before waiting on a condition variable
+     * (see ThreadPool::setSpinCount).
+     */
+    void setSpinCount(int spinCount) noexcept
+    {
+        _threadPool->setSpinCount(spinCount);
+    }
+
+    /**
+     * @brief Indicates if the calling thread calculates pending losses too instead of waiting for the managed threads
+     * (see ThreadPool::isCallerParticipationEnabled).
+     */
+    bool isCallerParticipationEnabled() const noexcept
+    {
+        return _threadPool->isCallerParticipationEnabled();
+    }
+
+    /**
+     * @brief Specifies if the calling thread calculates pending losses too instead of waiting for the managed threads
+     * (disabled by default, see ThreadPool::setCallerParticipationEnabled).
+     */
+    void setCallerParticipationEnabled(bool enabled) noexcept
+    {
+        _threadPool->setCallerParticipationEnabled(enabled);
+    }
+
+    /**
+     * @brief Indicates if each thread calculates losses with its own copy of the loss function.
+     */
+    bool isLossFunctionClonesEnabled() const noexcept
+    {
+        return _lossFunctionClonesEnabled;
+    }
+
+    /**
+     * @brief Specifies if each thread calculates losses with its own copy of the loss function
+     * (disabled by default).
+     *
+     * Copies are created once per thread with cloneLossFunction, so they can keep private scratch buffers.
+     * The thread which calls this evaluator uses the original loss function.
+     *
+     * If the loss function is modified after creating its copies, resetLossFunctionClones must be called.
+     */
+    void setLossFunctionClonesEnabled(bool enabled)
+    {
+        _lossFunctionClonesEnabled = enabled;
+
+        if(! enabled)
+        {
+            resetLossFunctionClones();
+        }
+    }
+
+    /**
+     * @brief Destroys the loss function copies of each thread, so they are created again on the next evaluation.
+     */
+    void resetLossFunctionClones()
+    {
+        // Stragglers running in the background can be using the current copies:
+        _threadPool->join();
+
+        _lossFunctionClones.clear();
+        _clonedLossFunction = nullptr;
+    }
+
+    /**
+     * @brief Returns the maximum time spent calculating the losses of a set of solutions.
+     * Zero means that there's no deadline.
+     */
+    std::chrono::nanoseconds getDeadline() const noexcept
+    {
+        return _deadline;
+    }
+
+    /**
+     * @brief Specifies the maximum time spent calculating the losses of a set of solutions.
+     * Zero (the default) means that there's no deadline.
+     */
+    void setDeadline(std::chrono::nanoseconds deadline)
+    {
+        HIKE_ASSERT(deadline.count() >= 0);
+
+        _deadline = deadline;
+    }
+
+    /**
+     * @brief Returns the fraction of solutions whose evaluation time limits the evaluation of the remaining ones.
+     * Zero means that the quantile cutoff is disabled.
+     */
+    double getQuantile() const noexcept
+    {
+        return _quantile;
+    }
+
+    /**
+     * @brief Returns the factor applied to the quantile evaluation time to get the time limit
+     * of the remaining solutions.
+     */
+    double getQuantileFactor() const noexcept
+    {
+        return _quantileFactor;
+    }
+
+    /**
+     * @brief Specifies a quantile cutoff: when the losses of the given fraction of solutions have been calculated
+     * in t time, the remaining solutions are only waited for until factor * t.
+     * @param quantile Fraction of solutions whose losses must be calculated, between zero and one.
+     * Zero (the default) disables the quantile cutoff.
+     * @param factor Factor applied to the quantile evaluation time. It must not be lower than one.
+     */
+    void setQuantileCutoff(double quantile, double factor)
+    {
+        HIKE_ASSERT(quantile >= 0 && quantile <= 1);
+        HIKE_ASSERT(factor >= 1);
+
+        _quantile = quantile;
+        _quantileFactor = factor;
+    }
+
+    /**
+     * @brief Calculates the losses of the given solutions.
+     * @param lossFunction Loss function used to calculate the losses.
+     * It must be thread safe, unless loss function clones are enabled.
+     * @param solutionsAndLosses Solutions to evaluate. Their losses are stored in the second member of each pair.
+     * @param cutoff Losses not lower than this value don't need to be exact (see HasCutoff).
+     * Stragglers get this loss if a deadline or a quantile cutoff is specified.
+     */
+    template<class SolutionsAllocator>
+    void operator()(LossFunction& lossFunction,
+                    std::vector<std::pair<Solution, LossType>, SolutionsAllocator>& solutionsAndLosses,
+                    const LossType& cutoff)
+    {
+        std::vector<std::unique_ptr<LossFunction>>* lossFunctionClones = nullptr;
+
+        if(_lossFunctionClonesEnabled)
+        {
+            _updateLossFunctionClones(lossFunction);
+            lossFunctionClones = &_lossFunctionClones;
+        }
+
+        if(_deadline.count() || _quantile > 0)
+        {
+            _evaluateBatch(lossFunction, lossFunctionClones, solutionsAndLosses, cutoff);
+            return;
+        }
+
+        for(std::pair<Solution, LossType>& solutionAndLoss : solutionsAndLosses)
+        {
+            _threadPool->add(LossTask(lossFunction, lossFunctionClones, &solutionAndLoss, cutoff));
+        }
+
+        _threadPool->join();
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    // Solutions evaluated with a deadline, owned by the evaluation tasks since stragglers can outlive the call:
+    struct Batch
+    {
+        std::vector<std::pair<Solution, LossType>> solutionsAndLosses;
+        std::vector<bool> finished;
+        _BatchCandidates<Solution> candidates;
+        std::size_t finishedCount;
+        std::atomic<bool> cancelled;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        Batch() :
+            finishedCount(0),
+            cancelled(false)
+        {
+        }
+    };
+
+    class LossTask
+    {
+
+    public:
+        LossTask(LossFunction& lossFunction, std::vector<std::unique_ptr<LossFunction>>* lossFunctionClones,
+                 std::pair<Solution, LossType>* solutionAndLoss, const LossType& cutoff) :
+            _lossFunction(lossFunction),
+            _lossFunctionClones(lossFunctionClones),
+            _solutionAndLoss(solutionAndLoss),
+            _cutoff(cutoff),
+            _index(0)
+        {
+        }
+
+        LossTask(LossFunction& lossFunction, std::vector<std::unique_ptr<LossFunction>>* lossFunctionClones,
+                 std::shared_ptr<Batch> batch, std::size_t index, const LossType& cutoff) :
+            _lossFunction(lossFunction),
+            _lossFunctionClones(lossFunctionClones),
+            _solutionAndLoss(&batch->solutionsAndLosses[index]),
+            _cutoff(cutoff),
+            _batch(std::move(batch)),
+            _index(index)
+        {
+        }
+
+        void operator()()
+        {
+            if(_batch && _batch->cancelled.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            LossFunction* lossFunction = &_lossFunction;
+            int workerIndex = ThreadPoolWorker::getIndex();
+
+            if(_lossFunctionClones && workerIndex >= 0)
+            {
+                lossFunction = (*_lossFunctionClones)[std::size_t(workerIndex)].get();
+            }
+
+            _solutionAndLoss->second = evaluateLoss(*lossFunction, _solutionAndLoss->first, _cutoff);
+
+            if(_batch)
+            {
+                std::lock_guard<std::mutex> lock(_batch->mutex);
+                _batch->finished[_index] = true;
+                ++_batch->finishedCount;
+                _batch->condition.notify_all();
+            }
+        }
+
+    protected:
+        LossFunction& _lossFunction;
+        std::vector<std::unique_ptr<LossFunction>>* _lossFunctionClones;
+        std::pair<Solution, LossType>* _solutionAndLoss;
+        LossType _cutoff;
+        std::shared_ptr<Batch> _batch;
+        std::size_t _index;
+    };
+
+    // Loss function copies are declared first, so the thread pool finishes background stragglers
+    // before they are destroyed:
+    std::vector<std::unique_ptr<LossFunction>> _lossFunctionClones;
+    std::unique_ptr<ThreadPool<LossTask>> _threadPool;
+    const LossFunction* _clonedLossFunction;
+    bool _lossFunctionClonesEnabled;
+    std::chrono::nanoseconds _deadline;
+    double _quantile;
+    double _quantileFactor;
+
+    template<class SolutionsAllocator>
+    void _evaluateBatch(LossFunction& lossFunction, std::vector<std::unique_ptr<LossFunction>>* lossFunctionClones,
+                        std::vector<std::pair<Solution, LossType>, SolutionsAllocator>& solutionsAndLosses,
+                        const LossType& cutoff)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        std::size_t solutionsCount = solutionsAndLosses.size();
+        std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+        batch->solutionsAndLosses.reserve(solutionsCount);
+        batch->finished.assign(solutionsCount, false);
+
+        for(std::pair<Solution, LossType>& solutionAndLoss : solutionsAndLosses)
+        {
+            batch->solutionsAndLosses.emplace_back(batch->candidates.store(solutionAndLoss.first), cutoff);
+        }
+
+        Clock::time_point startTime = Clock::now();
+
+        for(std::size_t index = 0; index < solutionsCount; ++index)
+        {
+            _threadPool->add(LossTask(lossFunction, lossFunctionClones, batch, index, cutoff));
+        }
+
+        Clock::time_point deadline = Clock::time_point::max();
+
+        if(_deadline.count())
+        {
+            deadline = startTime + std::chrono::duration_cast<Clock::duration>(_deadline);
+        }
+
+        auto quantileCount = std::size_t(std::ceil(_quantile * double(solutionsCount)));
+        bool quantileReached = _quantile <= 0;
+
+        std::unique_lock<std::mutex> lock(batch->mutex);
+
+        while(batch->finishedCount < solutionsCount)
+        {
+            if(! quantileReached && batch->finishedCount >= quantileCount)
+            {
+                auto quantileTime = std::chrono::duration<double>(Clock::now() - startTime) * _quantileFactor;
+                deadline = std::min(deadline, startTime + std::chrono::duration_cast<Clock::duration>(quantileTime));
+                quantileReached = true;
+            }
+
+            if(deadline == Clock::time_point::max())
+            {
+                batch->condition.wait(lock);
+            }
+            else if(batch->condition.wait_until(lock, deadline) == std::cv_status::timeout)
+            {
+                break;
+            }
+        }
+
+        // Stragglers which have not been started are cancelled, and the running ones keep the batch alive:
+
+        batch->cancelled.store(true, std::memory_order_relaxed);
+
+        for(std::size_t index = 0; index < solutionsCount; ++index)
+        {
+            std::pair<Solution, LossType>& solutionAndLoss = solutionsAndLosses[index];
+
+            if(batch->finished[index])
+            {
+                std::pair<Solution, LossType>& batchSolutionAndLoss = batch->solutionsAndLosses[index];
+                batch->candidates.restore(solutionAndLoss.first, batchSolutionAndLoss.first);
+                solutionAndLoss.second = batchSolutionAndLoss.second;
+            }
+            else
+            {
+                solutionAndLoss.second = cutoff;
+            }
+        }
+    }
+
+    void _updateLossFunctionClones(const LossFunction& lossFunction)
+    {
+        // Clones are created in the calling thread, since the original loss function is not required to be
+        // thread safe:
+        if(_clonedLossFunction != &lossFunction)
+        {
+            resetLossFunctionClones();
+            _lossFunctionClones.reserve(_threadPool->getThreadsCount());
+
+            for(std::size_t index = 0; index < _threadPool->getThreadsCount(); ++index)
+            {
+                _lossFunctionClones.emplace_back(new LossFunction(cloneLossFunction(lossFunction)));
+            }
+
+            _clonedLossFunction = &lossFunction;
+        }
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
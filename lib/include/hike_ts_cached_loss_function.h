@@ -2,9 +2,15 @@
 #define HIKE_TS_CACHED_LOSS_FUNCTION_H
 
 #include <memory>
+#include <cstring>
 #include <type_traits>
-#include <unordered_map>
+#include <functional>
 #include <mutex>
+#include "hike_loss_function_traits.h"
+#include "hike_serializer.h"
+#include "hike_solution_hash.h"
+#include "hike_solution_map.h"
+#include "hike_zobrist_hash.h"
 
 namespace hike
 {
@@ -13,8 +19,19 @@ namespace hike
  * @brief Remembers previously calculated losses from multiple threads.
  *
  * This class is thread safe as long as the child loss function is thread safe too.
+ *
+ * Copies of this class share the same cache, so they can be used by multiple optimization processes at once.
+ *
+ * If the child loss function changes over time, nextEpoch must be called to invalidate the cached losses.
+ *
+ * Solutions are identified with the given SolutionHash, which by default supports containers
+ * of arithmetic parameters and falls back to std::hash otherwise. Only with ZobristHash, local searches pass
+ * their candidate solutions already hashed (see HasHashedLoss), so cache lookups don't hash them again.
+ *
+ * Cache entries are allocated with the given Allocator (see PoolAllocator).
  */
-template<class Solution, class LossFunction, class SolutionHash = std::hash<Solution>>
+template<class Solution, class LossFunction, class SolutionHash = hike::SolutionHash<Solution>,
+         class Allocator = std::allocator<Solution>>
 class TSCachedLossFunction
 {
 
@@ -30,7 +47,7 @@ public:
      */
     explicit TSCachedLossFunction(const LossFunction& lossFunction) :
         _lossFunction(lossFunction),
-        _mutex(new std::mutex())
+        _cache(std::make_shared<Cache>())
     {
     }
 
@@ -40,8 +57,92 @@ public:
      */
     explicit TSCachedLossFunction(LossFunction&& lossFunction) :
         _lossFunction(std::move(lossFunction)),
-        _mutex(new std::mutex())
+        _cache(std::make_shared<Cache>())
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param lossFunction Thread safe loss function used to calculate the loss of new solutions.
+     * @param allocator Allocator used to allocate cache entries. It is only used with the cache mutex locked.
+     */
+    TSCachedLossFunction(const LossFunction& lossFunction, const Allocator& allocator) :
+        _lossFunction(lossFunction),
+        _cache(std::make_shared<Cache>(allocator))
+    {
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param lossFunction Thread safe loss function used to calculate the loss of new solutions.
+     * @param allocator Allocator used to allocate cache entries. It is only used with the cache mutex locked.
+     */
+    TSCachedLossFunction(LossFunction&& lossFunction, const Allocator& allocator) :
+        _lossFunction(std::move(lossFunction)),
+        _cache(std::make_shared<Cache>(allocator))
+    {
+    }
+
+    /**
+     * @brief Returns the current epoch of the cache.
+     */
+    std::uint64_t getEpoch() const
+    {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        return _cache->epoch;
+    }
+
+    /**
+     * @brief Starts a new epoch, so losses calculated before are not returned anymore.
+     *
+     * It must be called when the child loss function changes. Losses of the previous epoch are only available
+     * as hints (see findHint), and older ones are reclaimed lazily when new losses are cached.
+     */
+    void nextEpoch()
+    {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        ++_cache->epoch;
+        _cache->reclaimIt = _cache->losses.begin();
+        _cache->reclaimBucketCount = _cache->losses.bucket_count();
+        _cache->reclaimPending = true;
+    }
+
+    /**
+     * @brief Returns the number of cached losses, including the ones which have not been reclaimed yet.
+     */
+    std::size_t getCachedLossesCount() const
+    {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        return _cache->losses.size();
+    }
+
+    /**
+     * @brief Searches a cached loss of the given solution from the current or the previous epoch.
+     *
+     * Hints can be used to order candidate solutions or as approximate losses, but they can be stale
+     * or lower bounds only.
+     *
+     * @param solution Solution to search.
+     * @param loss Output parameter which contains the cached loss if it has been found.
+     * @return true if a cached loss has been found, otherwise false.
+     */
+    bool findHint(const Solution& solution, LossType& loss) const
     {
+        std::size_t hash = _cache->losses.hash(solution);
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        auto lossIt = _cache->losses.find(solution, hash);
+
+        if(lossIt == _cache->losses.end() || lossIt->second.value.epoch + 1 < _cache->epoch)
+        {
+            return false;
+        }
+
+        loss = lossIt->second.value.loss;
+        return true;
     }
 
     /**
@@ -49,34 +150,274 @@ public:
      */
     LossType operator()(const Solution& solution)
     {
+        std::size_t hash = _cache->losses.hash(solution);
+        std::uint64_t epoch;
+
         {
-            std::lock_guard<std::mutex> lock(*_mutex);
+            std::lock_guard<std::mutex> lock(_cache->mutex);
 
-            auto lossIt = _losses.find(solution);
+            auto lossIt = _cache->losses.find(solution, hash);
+            epoch = _cache->epoch;
 
-            if(lossIt != _losses.end())
+            if(lossIt != _cache->losses.end() && lossIt->second.value.exact && lossIt->second.value.epoch == epoch)
             {
-                return lossIt->second;
+                return lossIt->second.value.loss;
             }
         }
 
         auto loss = _lossFunction(solution);
+        _store(solution, hash, CachedLoss{ loss, true, epoch });
+
+        return loss;
+    }
+
+    /**
+     * @brief Returns the loss of the given solution if it is lower than the given cutoff value.
+     * Otherwise, it returns a value not lower than the cutoff value.
+     *
+     * The cutoff value is passed to the child loss function if it supports it (see HasCutoff).
+     * In that case, returned losses not lower than the cutoff value are cached as lower bounds only.
+     */
+    LossType operator()(const Solution& solution, const LossType& cutoff)
+    {
+        return _loss(solution, _cache->losses.hash(solution), cutoff);
+    }
 
+    /**
+     * @brief Returns the loss of the given solution, whose hash is already known (see HasHashedLoss),
+     * if it is lower than the given cutoff value. Otherwise, it returns a value not lower than the cutoff value.
+     *
+     * It is available only if SolutionHash is ZobristHash, so known hashes are always valid cache keys.
+     */
+    template<class SolutionHashType = SolutionHash>
+    auto hashedLoss(const HashedSolution<Solution>& hashedSolution, const LossType& cutoff)
+        -> typename std::enable_if<std::is_same<SolutionHashType, ZobristHash<Solution>>::value, LossType>::type
+    {
+        return _loss(hashedSolution.solution, hashedSolution.hash, cutoff);
+    }
+
+    /**
+     * @brief Appends the cached losses of the current and the previous epoch to the given buffer,
+     * so they can be restored later with load.
+     *
+     * Solutions and losses are converted to bytes with the given serializers (see Serializer).
+     */
+    template<class SolutionSerializer = Serializer<Solution>, class LossSerializer = Serializer<LossType>>
+    void save(std::vector<char>& buffer) const
+    {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        std::size_t lossesCountPosition = buffer.size();
+        std::uint64_t lossesCount = 0;
+        Serializer<std::uint64_t>::write(lossesCount, buffer);
+
+        for(const auto& solutionAndLoss : _cache->losses)
         {
-            std::lock_guard<std::mutex> lock(*_mutex);
+            const CachedLoss& cachedLoss = solutionAndLoss.second.value;
 
-            _losses.insert(std::make_pair(solution, loss));
+            if(cachedLoss.epoch + 1 >= _cache->epoch)
+            {
+                SolutionSerializer::write(solutionAndLoss.second.solution, buffer);
+                LossSerializer::write(cachedLoss.loss, buffer);
+                Serializer<bool>::write(cachedLoss.exact, buffer);
+                Serializer<bool>::write(cachedLoss.epoch == _cache->epoch, buffer);
+                ++lossesCount;
+            }
         }
 
-        return loss;
+        std::memcpy(buffer.data() + lossesCountPosition, &lossesCount, sizeof(lossesCount));
+    }
+
+    /**
+     * @brief Adds the cached losses stored by save to this cache.
+     *
+     * Losses of the current epoch of the saved cache are added to the current epoch of this one,
+     * and the other ones to the previous epoch.
+     *
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @return true if the cached losses have been read successfully, otherwise false.
+     */
+    template<class SolutionSerializer = Serializer<Solution>, class LossSerializer = Serializer<LossType>>
+    bool load(const char*& data, const char* dataEnd)
+    {
+        std::uint64_t lossesCount;
+
+        if(! Serializer<std::uint64_t>::read(data, dataEnd, lossesCount))
+        {
+            return false;
+        }
+
+        std::uint64_t epoch = getEpoch();
+        Solution solution;
+        LossType loss;
+        bool exact;
+        bool current;
+
+        for(std::uint64_t index = 0; index < lossesCount; ++index)
+        {
+            if(! SolutionSerializer::read(data, dataEnd, solution) || ! LossSerializer::read(data, dataEnd, loss) ||
+                    ! Serializer<bool>::read(data, dataEnd, exact) || ! Serializer<bool>::read(data, dataEnd, current))
+            {
+                return false;
+            }
+
+            _store(solution, _cache->losses.hash(solution), CachedLoss{ loss, exact, current ? epoch : epoch - 1 });
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Returns a lower bound of the loss of the solutions
+     * whose parameters in the range [0, paramIndex] are equal to the given solution ones.
+     *
+     * It is available only if the child loss function provides lower bounds (see HasLowerBound).
+     */
+    template<class LossFunctionType = LossFunction>
+    auto lowerBound(const Solution& solution, std::size_t paramIndex)
+        -> decltype(std::declval<LossFunctionType&>().lowerBound(solution, paramIndex))
+    {
+        return _lossFunction.lowerBound(solution, paramIndex);
+    }
+
+    /**
+     * @brief Returns a cheap approximation of the loss of the given solution, which is not cached.
+     *
+     * It is available only if the child loss function provides surrogate losses (see HasSurrogate).
+     */
+    template<class LossFunctionType = LossFunction>
+    auto surrogate(const Solution& solution) -> decltype(std::declval<LossFunctionType&>().surrogate(solution))
+    {
+        return _lossFunction.surrogate(solution);
     }
 
 protected:
     ///@cond INTERNAL
 
+    struct CachedLoss
+    {
+        LossType loss;
+        bool exact;
+        std::uint64_t epoch;
+    };
+
+    using Losses = _SolutionMap<Solution, CachedLoss, SolutionHash, Allocator>;
+
+    struct Cache
+    {
+        std::mutex mutex;
+        Losses losses;
+        std::uint64_t epoch;
+        typename Losses::iterator reclaimIt;
+        std::size_t reclaimBucketCount;
+        bool reclaimPending;
+
+        Cache() :
+            epoch(1),
+            reclaimBucketCount(0),
+            reclaimPending(false)
+        {
+        }
+
+        explicit Cache(const Allocator& allocator) :
+            losses(allocator),
+            epoch(1),
+            reclaimBucketCount(0),
+            reclaimPending(false)
+        {
+        }
+    };
+
     LossFunction _lossFunction;
-    std::unordered_map<Solution, LossType, SolutionHash> _losses;
-    std::unique_ptr<std::mutex> _mutex;
+    std::shared_ptr<Cache> _cache;
+
+    LossType _loss(const Solution& solution, std::size_t hash, const LossType& cutoff)
+    {
+        std::uint64_t epoch;
+
+        {
+            std::lock_guard<std::mutex> lock(_cache->mutex);
+
+            auto lossIt = _cache->losses.find(solution, hash);
+            epoch = _cache->epoch;
+
+            if(lossIt != _cache->losses.end())
+            {
+                const CachedLoss& cachedLoss = lossIt->second.value;
+
+                if(cachedLoss.epoch == epoch && (cachedLoss.exact || ! (cachedLoss.loss < cutoff)))
+                {
+                    return cachedLoss.loss;
+                }
+            }
+        }
+
+        // If a new epoch starts while the loss is calculated, it is stored in the previous one:
+
+        auto loss = evaluateLoss(_lossFunction, solution, cutoff);
+        _store(solution, hash, CachedLoss{ loss, ! HasCutoff<LossFunction, Solution>::value || loss < cutoff, epoch });
+
+        return loss;
+    }
+
+    void _store(const Solution& solution, std::size_t hash, const CachedLoss& cachedLoss)
+    {
+        std::lock_guard<std::mutex> lock(_cache->mutex);
+
+        auto lossIt = _cache->losses.find(solution, hash);
+
+        if(lossIt == _cache->losses.end())
+        {
+            _insert(solution, hash, cachedLoss);
+        }
+        else if(cachedLoss.epoch > lossIt->second.value.epoch ||
+                (cachedLoss.epoch == lossIt->second.value.epoch &&
+                 (cachedLoss.exact || ! lossIt->second.value.exact)))
+        {
+            // Exact losses replace lower bounds, but lower bounds never replace exact losses of the same epoch:
+
+            lossIt->second.value = cachedLoss;
+        }
+    }
+
+    void _insert(const Solution& solution, std::size_t hash, const CachedLoss& cachedLoss)
+    {
+        Cache& cache = *_cache;
+        _reclaim();
+        cache.losses.insert(solution, hash, cachedLoss);
+
+        if(cache.reclaimPending && cache.losses.bucket_count() != cache.reclaimBucketCount)
+        {
+            // Rehashing invalidates the reclaim iterator, so the reclaim starts again:
+
+            cache.reclaimIt = cache.losses.begin();
+            cache.reclaimBucketCount = cache.losses.bucket_count();
+        }
+    }
+
+    void _reclaim()
+    {
+        // Losses older than the previous epoch are erased a few at a time, so starting a new epoch is cheap:
+
+        Cache& cache = *_cache;
+
+        for(int count = 0; cache.reclaimPending && count < 2; ++count)
+        {
+            if(cache.reclaimIt == cache.losses.end())
+            {
+                cache.reclaimPending = false;
+            }
+            else if(cache.reclaimIt->second.value.epoch + 1 < cache.epoch)
+            {
+                cache.reclaimIt = cache.losses.erase(cache.reclaimIt);
+            }
+            else
+            {
+                ++cache.reclaimIt;
+            }
+        }
+    }
 
     ///@endcond
 };
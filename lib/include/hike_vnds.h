@@ -0,0 +1,224 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_VNDS_H
+#define HIKE_VNDS_H
+
+#include <limits>
+#include <random>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include "hike_common.h"
+
+namespace hike
+{
+
+/**
+ * @brief Variable neighborhood decomposition search, aimed for problems with lots of parameters.
+ *
+ * Instead of searching all parameters at once, the given VNS is applied to subsets of k parameters,
+ * with the other ones frozen. Subsets are taken in blocks from a random permutation of all parameters,
+ * so every parameter is searched once per pass. If a pass improves the solution, k is reset to 1.
+ * Otherwise, k is incremented until it exceeds the maximum number of parameters per subset.
+ *
+ * The local search of the given VNS must provide a setStepSolution method
+ * which freezes the parameters with a zero step (like FILocalSearch, BILocalSearch and ParallelBILocalSearch).
+ *
+ * https://en.wikipedia.org/wiki/Variable_neighborhood_search
+ */
+template<class Solution, class VNS>
+class VNDS
+{
+
+public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename VNS::LossType;
+
+    /**
+     * @brief Class constructor.
+     * @param vns VNS object applied to each subset of parameters.
+     * @param stepSolution Step of each parameter when it is not frozen.
+     * @param maxParams Maximum number of parameters per subset.
+     */
+    template<class VNSType, class SolutionType>
+    VNDS(VNSType&& vns, SolutionType&& stepSolution, std::size_t maxParams) :
+        _vns(std::forward<VNSType>(vns)),
+        _stepSolution(std::forward<SolutionType>(stepSolution))
+    {
+        setMaxParams(maxParams);
+    }
+
+    /**
+     * @brief Returns the VNS object applied to each subset of parameters.
+     */
+    const VNS& getVNS() const noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the VNS object applied to each subset of parameters.
+     */
+    VNS& getVNS() noexcept
+    {
+        return _vns;
+    }
+
+    /**
+     * @brief Returns the maximum number of parameters per subset.
+     */
+    std::size_t getMaxParams() const noexcept
+    {
+        return _maxParams;
+    }
+
+    /**
+     * @brief Specifies the maximum number of parameters per subset.
+     */
+    void setMaxParams(std::size_t maxParams)
+    {
+        HIKE_ASSERT(maxParams > 0);
+
+        _maxParams = maxParams;
+    }
+
+    /**
+     * @brief Specifies the seed of the random number generator used to select the subsets of parameters.
+     */
+    void setSeed(unsigned int seed)
+    {
+        _random.seed(seed);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution)
+    {
+        bool optimized;
+
+        return optimize(std::forward<SolutionType>(solution), optimized);
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution.
+     * @param solution The solution to optimize.
+     * @param optimized Output parameter which indicates if the input solution has been optimized or not.
+     * @return The optimized solution.
+     */
+    template<class SolutionType>
+    Solution optimize(SolutionType&& solution, bool& optimized)
+    {
+        Solution bestSolution = std::forward<SolutionType>(solution);
+        std::size_t size = bestSolution.size();
+        HIKE_ASSERT(size == _stepSolution.size());
+
+        auto& localSearch = _vns.getLocalSearch();
+        LossType bestLoss = localSearch.getLossFunction()(bestSolution);
+        std::size_t maxParams = std::min(_maxParams, size);
+        optimized = false;
+
+        _paramIndices.resize(size);
+
+        for(std::size_t paramIndex = 0; paramIndex < size; ++paramIndex)
+        {
+            _paramIndices[paramIndex] = paramIndex;
+        }
+
+        // All parameters are frozen by default:
+
+        _subsetStepSolution = _stepSolution;
+
+        for(std::size_t paramIndex = 0; paramIndex < size; ++paramIndex)
+        {
+            _subsetStepSolution[paramIndex] = Param();
+        }
+
+        for(std::size_t params = 1; params <= maxParams; )
+        {
+            std::shuffle(_paramIndices.begin(), _paramIndices.end(), _random);
+            bool improved = false;
+
+            for(std::size_t first = 0; first < size; first += params)
+            {
+                std::size_t last = std::min(first + params, size);
+                _setSubsetSteps(first, last, true);
+                localSearch.setStepSolution(_subsetStepSolution);
+
+                typename VNS::State state = _vns.createState(bestSolution, bestLoss);
+
+                while(! _vns.iterate(state, std::numeric_limits<int>::max()))
+                {
+                }
+
+                _setSubsetSteps(first, last, false);
+
+                if(state.loss < bestLoss)
+                {
+                    // Merge the improved subset into the best solution:
+
+                    bestSolution = std::move(state.solution);
+                    bestLoss = state.loss;
+                    improved = true;
+                    optimized = true;
+                }
+            }
+
+            params = improved ? 1 : params + 1;
+        }
+
+        localSearch.setStepSolution(_stepSolution);
+
+        return bestSolution;
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    using Param = typename std::decay<decltype(std::declval<const Solution&>()[0])>::type;
+
+    VNS _vns;
+    Solution _stepSolution;
+    Solution _subsetStepSolution;
+    std::vector<std::size_t> _paramIndices;
+    std::mt19937 _random;
+    std::size_t _maxParams;
+
+    void _setSubsetSteps(std::size_t first, std::size_t last, bool enabled)
+    {
+        for(std::size_t index = first; index < last; ++index)
+        {
+            std::size_t paramIndex = _paramIndices[index];
+            _subsetStepSolution[paramIndex] = enabled ? _stepSolution[paramIndex] : Param();
+        }
+    }
+
+    ///@endcond
+};
+
+}
+
+#endif
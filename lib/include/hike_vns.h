@@ -19,25 +19,108 @@
 #ifndef HIKE_VNS_H
 #define HIKE_VNS_H
 
+#include <limits>
+#include <cstdint>
 #include <utility>
+#include <type_traits>
 #include "hike_empty_on_improved_solution.h"
+#include "hike_neighborhood_schedules.h"
 
 namespace hike
 {
 
+///@cond INTERNAL
+
+template<class LocalSearch, class Solution>
+class _HasInPlaceOptimize
+{
+
+protected:
+    template<class LocalSearchType>
+    static auto _test(int) -> decltype(std::declval<LocalSearchType&>().optimize(
+                                           std::declval<const Solution&>(), std::declval<Solution&>(),
+                                           std::declval<bool&>()), std::true_type());
+
+    template<class LocalSearchType>
+    static std::false_type _test(...);
+
+public:
+    static constexpr bool value = decltype(_test<LocalSearch>(0))::value;
+};
+
+template<class LocalSearch>
+class _HasEvaluationsCount
+{
+
+protected:
+    template<class LocalSearchType>
+    static auto _test(int) -> decltype(std::declval<const LocalSearchType&>().getEvaluationsCount(),
+                                       std::true_type());
+
+    template<class LocalSearchType>
+    static std::false_type _test(...);
+
+public:
+    static constexpr bool value = decltype(_test<LocalSearch>(0))::value;
+};
+
+///@endcond
+
 /**
  * @brief Basic variable neighborhood search.
  *
  * It is aimed for solving linear program problems, integer program problems, mixed integer program problems,
  * nonlinear program problems, etc.
  *
+ * The sequence of neighborhoods passed to the local search is controlled by a neighborhood schedule
+ * (see LinearNeighborhoodSchedule).
+ *
  * https://en.wikipedia.org/wiki/Variable_neighborhood_search
  */
-template<class Solution, class LocalSearch, class OnImprovedSolution = EmptyOnImprovedSolution>
+template<class Solution, class LocalSearch, class OnImprovedSolution = EmptyOnImprovedSolution,
+         class NeighborhoodSchedule = LinearNeighborhoodSchedule>
 class VNS
 {
 
 public:
+    /**
+     * Loss function return type.
+     */
+    using LossType = typename std::decay<decltype(
+        std::declval<LocalSearch&>().getLossFunction()(std::declval<const Solution&>()))>::type;
+
+    /**
+     * @brief Optimization process state, which allows to split it in multiple steps.
+     */
+    struct State
+    {
+        /**
+         * @brief Best solution found.
+         */
+        Solution solution;
+
+        /**
+         * @brief Loss of the best solution found.
+         */
+        LossType loss;
+
+        /**
+         * @brief Distance between the candidate solutions and the best one in the next local search.
+         * The optimization process has finished if it is greater than kmax.
+         */
+        int k;
+
+        /**
+         * @brief Neighborhood schedule state.
+         */
+        typename NeighborhoodSchedule::State scheduleState;
+
+        /**
+         * @brief Indicates if the input solution has been optimized or not.
+         */
+        bool optimized;
+    };
+
     /**
      * @brief Class constructor.
      * @param localSearch Object applied repeatedly to get from solutions in the neighborhood to local optima.
@@ -59,6 +142,28 @@ public:
     VNS(LocalSearchType&& localSearch, int kmax, OnImprovedSolutionType&& onImprovedSolution) :
         _localSearch(std::forward<LocalSearchType>(localSearch)),
         _onImprovedSolution(std::forward<OnImprovedSolutionType>(onImprovedSolution)),
+        _currentSolution(),
+        _localSearchesCount(0),
+        _kmax(kmax)
+    {
+        setKmax(kmax);
+    }
+
+    /**
+     * @brief Class constructor.
+     * @param localSearch Object applied repeatedly to get from solutions in the neighborhood to local optima.
+     * @param kmax Maximum distance between the candidate solutions and the input one.
+     * @param onImprovedSolution Callback called when a given solution is improved.
+     * @param neighborhoodSchedule Controls the sequence of neighborhoods passed to the local search.
+     */
+    template<class LocalSearchType, class OnImprovedSolutionType, class NeighborhoodScheduleType>
+    VNS(LocalSearchType&& localSearch, int kmax, OnImprovedSolutionType&& onImprovedSolution,
+        NeighborhoodScheduleType&& neighborhoodSchedule) :
+        _localSearch(std::forward<LocalSearchType>(localSearch)),
+        _onImprovedSolution(std::forward<OnImprovedSolutionType>(onImprovedSolution)),
+        _neighborhoodSchedule(std::forward<NeighborhoodScheduleType>(neighborhoodSchedule)),
+        _currentSolution(),
+        _localSearchesCount(0),
         _kmax(kmax)
     {
         setKmax(kmax);
@@ -114,6 +219,22 @@ public:
         return _onImprovedSolution;
     }
 
+    /**
+     * @brief Returns the object which controls the sequence of neighborhoods passed to the local search.
+     */
+    const NeighborhoodSchedule& getNeighborhoodSchedule() const noexcept
+    {
+        return _neighborhoodSchedule;
+    }
+
+    /**
+     * @brief Returns the object which controls the sequence of neighborhoods passed to the local search.
+     */
+    NeighborhoodSchedule& getNeighborhoodSchedule() noexcept
+    {
+        return _neighborhoodSchedule;
+    }
+
     /**
      * @brief optimize Minimizes the loss function with the given solution.
      * @param solution The solution to optimize.
@@ -136,43 +257,124 @@ public:
     template<class SolutionType>
     Solution optimize(SolutionType&& solution, bool& optimized)
     {
-        Solution bestSolution = std::forward<SolutionType>(solution);
-        auto& lossFunction = _localSearch.getLossFunction();
-        auto bestLoss = lossFunction(bestSolution);
-        int k = 1;
-        optimized = false;
+        State state = createState(std::forward<SolutionType>(solution));
 
-        while(k <= _kmax)
+        while(! iterate(state, std::numeric_limits<int>::max()))
         {
-            _localSearch.setNeighborhood(k);
+        }
 
-            bool localSearchOptimized;
-            Solution currentSolution = _localSearch.optimize(bestSolution, localSearchOptimized);
+        optimized = state.optimized;
+        return std::move(state.solution);
+    }
 
-            if(localSearchOptimized)
-            {
-                auto currentLoss = lossFunction(currentSolution);
-
-                if(currentLoss < bestLoss)
-                {
-                    _onImprovedSolution(bestSolution, bestLoss, currentSolution, currentLoss, k);
-                    bestSolution = std::move(currentSolution);
-                    bestLoss = currentLoss;
-                    k = 1;
-                    optimized = true;
-                }
-                else
-                {
-                    ++k;
-                }
-            }
-            else
+    /**
+     * @brief Creates the initial state of the optimization of the given solution.
+     * @param solution The solution to optimize.
+     * @return The initial optimization state.
+     */
+    template<class SolutionType>
+    State createState(SolutionType&& solution)
+    {
+        State state{ std::forward<SolutionType>(solution), LossType(), 0,
+                    typename NeighborhoodSchedule::State(), false };
+        state.loss = _localSearch.getLossFunction()(state.solution);
+        state.k = _neighborhoodSchedule.first(state.scheduleState, _kmax);
+        return state;
+    }
+
+    /**
+     * @brief Creates the initial state of the optimization of the given solution.
+     * @param solution The solution to optimize.
+     * @param loss Loss of the solution to optimize.
+     * @return The initial optimization state.
+     */
+    template<class SolutionType>
+    State createState(SolutionType&& solution, const LossType& loss)
+    {
+        State state{ std::forward<SolutionType>(solution), loss, 0, typename NeighborhoodSchedule::State(), false };
+        state.k = _neighborhoodSchedule.first(state.scheduleState, _kmax);
+        return state;
+    }
+
+    /**
+     * @brief Continues the optimization process with the given state.
+     * @param state Optimization state to update.
+     * @param maxIterations Maximum number of local searches to apply.
+     * @return true if the optimization process has finished, otherwise false.
+     */
+    bool iterate(State& state, int maxIterations)
+    {
+        LossType currentLoss = LossType();
+
+        for(int iteration = 0; iteration < maxIterations && state.k <= _kmax; ++iteration)
+        {
+            NeighborhoodResult result = searchNeighborhood(state.solution, state.loss, state.k, _currentSolution,
+                                                           currentLoss);
+            updateState(state, result, _currentSolution, currentLoss);
+        }
+
+        return state.k > _kmax;
+    }
+
+    /**
+     * @brief Applies the local search with the given neighborhood to a solution, without updating any state.
+     *
+     * It allows to run the local searches of an optimization process in other objects (see SpeculativeVNS).
+     *
+     * @param solution The solution to optimize.
+     * @param loss Loss of the solution to optimize.
+     * @param k Distance between the candidate solutions and the solution to optimize.
+     * @param candidate Output parameter which contains the local search result.
+     * @param candidateLoss Output parameter which contains the loss of the local search result
+     * (only if it has improved the solution to optimize).
+     * @return Local search result, to pass to updateState.
+     */
+    NeighborhoodResult searchNeighborhood(const Solution& solution, const LossType& loss, int k,
+                                          Solution& candidate, LossType& candidateLoss)
+    {
+        _localSearch.setNeighborhood(k);
+
+        std::uint64_t evaluationsCount = _getEvaluationsCount();
+        bool localSearchOptimized;
+        _optimizeLocally(solution, candidate, localSearchOptimized);
+
+        NeighborhoodResult result{ k, false, 0, _getEvaluationsCount() - evaluationsCount };
+
+        if(localSearchOptimized)
+        {
+            candidateLoss = _localSearch.getLossFunction()(candidate);
+
+            if(candidateLoss < loss)
             {
-                ++k;
+                result.improved = true;
+                result.improvement = _getImprovement(loss, candidateLoss);
             }
         }
 
-        return bestSolution;
+        return result;
+    }
+
+    /**
+     * @brief Updates the given optimization state with a local search result.
+     * @param state Optimization state to update.
+     * @param result Result of a local search with the current neighborhood of the state (see searchNeighborhood).
+     * @param candidate Local search result. It is swapped with the best solution if it has improved it.
+     * @param candidateLoss Loss of the local search result.
+     */
+    void updateState(State& state, const NeighborhoodResult& result, Solution& candidate,
+                     const LossType& candidateLoss)
+    {
+        HIKE_ASSERT(result.k == state.k);
+
+        if(result.improved)
+        {
+            _onImprovedSolution(state.solution, state.loss, candidate, candidateLoss, state.k);
+            std::swap(state.solution, candidate);
+            state.loss = candidateLoss;
+            state.optimized = true;
+        }
+
+        state.k = _neighborhoodSchedule.next(state.scheduleState, result, _kmax);
     }
 
 protected:
@@ -180,8 +382,62 @@ protected:
 
     LocalSearch _localSearch;
     OnImprovedSolution _onImprovedSolution;
+    NeighborhoodSchedule _neighborhoodSchedule;
+    Solution _currentSolution;
+    std::uint64_t _localSearchesCount;
     int _kmax;
 
+    std::uint64_t _getEvaluationsCount() const
+    {
+        return _getEvaluationsCount(std::integral_constant<bool, _HasEvaluationsCount<LocalSearch>::value>());
+    }
+
+    std::uint64_t _getEvaluationsCount(std::true_type) const
+    {
+        return _localSearch.getEvaluationsCount();
+    }
+
+    std::uint64_t _getEvaluationsCount(std::false_type) const
+    {
+        // Each local search counts as one evaluation if the local search doesn't count them:
+        return _localSearchesCount;
+    }
+
+    static double _getImprovement(const LossType& inputLoss, const LossType& improvedLoss)
+    {
+        return _getImprovement(inputLoss, improvedLoss,
+                               std::integral_constant<bool, std::is_arithmetic<LossType>::value>());
+    }
+
+    static double _getImprovement(const LossType& inputLoss, const LossType& improvedLoss, std::true_type)
+    {
+        return double(inputLoss - improvedLoss);
+    }
+
+    static double _getImprovement(const LossType&, const LossType&, std::false_type)
+    {
+        return 1;
+    }
+
+    void _optimizeLocally(const Solution& solution, Solution& optimizedSolution, bool& optimized)
+    {
+        ++_localSearchesCount;
+        _optimizeLocally(solution, optimizedSolution, optimized,
+                         std::integral_constant<bool, _HasInPlaceOptimize<LocalSearch, Solution>::value>());
+    }
+
+    void _optimizeLocally(const Solution& solution, Solution& optimizedSolution, bool& optimized, std::true_type)
+    {
+        // The memory of the previous local search result is reused:
+
+        _localSearch.optimize(solution, optimizedSolution, optimized);
+    }
+
+    void _optimizeLocally(const Solution& solution, Solution& optimizedSolution, bool& optimized, std::false_type)
+    {
+        optimizedSolution = _localSearch.optimize(solution, optimized);
+    }
+
     ///@endcond
 };
 
@@ -0,0 +1,255 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+
+#ifndef HIKE_VNS_CHECKPOINT_H
+#define HIKE_VNS_CHECKPOINT_H
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include "hike_serializer.h"
+
+namespace hike
+{
+
+/**
+ * @brief Saves and loads the state of a variable neighborhood search to and from a binary file,
+ * so long optimization processes can be resumed after being interrupted.
+ *
+ * The best solution and its loss, the current neighborhood and the neighborhood schedule state
+ * (including its statistics and random number generator, if any) are stored, so resuming an optimization process
+ * doesn't require to calculate any loss.
+ *
+ * Checkpoint files can also contain arbitrary data, like the contents of a loss cache (see CachedLossFunction::save).
+ *
+ * Solutions and losses are converted to bytes with the given serializers (see Serializer).
+ */
+template<class Solution, class VNS, class SolutionSerializer = Serializer<Solution>,
+         class LossSerializer = Serializer<typename VNS::LossType>>
+class VNSCheckpoint
+{
+
+public:
+    /**
+     * Optimization process state.
+     */
+    using State = typename VNS::State;
+
+    /**
+     * @brief Class constructor.
+     * @param filePath Path of the checkpoint file.
+     */
+    explicit VNSCheckpoint(std::string filePath) :
+        _filePath(std::move(filePath)),
+        _saveFailed(false)
+    {
+    }
+
+    /**
+     * @brief Returns the path of the checkpoint file.
+     */
+    const std::string& getFilePath() const noexcept
+    {
+        return _filePath;
+    }
+
+    /**
+     * @brief Indicates if a checkpoint could not be saved during the last optimize call.
+     */
+    bool hasSaveFailed() const noexcept
+    {
+        return _saveFailed;
+    }
+
+    /**
+     * @brief Appends the bytes of the given optimization state to the given buffer.
+     */
+    static void write(const State& state, std::vector<char>& buffer)
+    {
+        Serializer<std::uint32_t>::write(_magic, buffer);
+        SolutionSerializer::write(state.solution, buffer);
+        LossSerializer::write(state.loss, buffer);
+        Serializer<int>::write(state.k, buffer);
+        Serializer<ScheduleState>::write(state.scheduleState, buffer);
+        Serializer<bool>::write(state.optimized, buffer);
+    }
+
+    /**
+     * @brief Reads an optimization state from the given bytes range.
+     * @param data Pointer to the first byte to read. It is moved past the read bytes.
+     * @param dataEnd Pointer past the last readable byte.
+     * @param state Output optimization state.
+     * @return true if the optimization state has been read successfully, otherwise false.
+     */
+    static bool read(const char*& data, const char* dataEnd, State& state)
+    {
+        std::uint32_t magic;
+
+        return Serializer<std::uint32_t>::read(data, dataEnd, magic) && magic == _magic &&
+                SolutionSerializer::read(data, dataEnd, state.solution) &&
+                LossSerializer::read(data, dataEnd, state.loss) &&
+                Serializer<int>::read(data, dataEnd, state.k) &&
+                Serializer<ScheduleState>::read(data, dataEnd, state.scheduleState) &&
+                Serializer<bool>::read(data, dataEnd, state.optimized);
+    }
+
+    /**
+     * @brief Stores the given optimization state in the checkpoint file.
+     *
+     * The file is written under a temporary name first, so an interrupted save doesn't corrupt
+     * the previous checkpoint.
+     *
+     * @param state Optimization state to store.
+     * @param userData Arbitrary data stored with the optimization state.
+     * @return true if the checkpoint file has been written successfully, otherwise false.
+     */
+    bool save(const State& state, const std::vector<char>& userData = std::vector<char>())
+    {
+        _buffer.clear();
+        write(state, _buffer);
+        Serializer<std::vector<char>>::write(userData, _buffer);
+
+        std::string temporaryFilePath = _filePath + ".tmp";
+
+        {
+            std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+            file.write(_buffer.data(), std::streamsize(_buffer.size()));
+
+            if(! file.flush())
+            {
+                return false;
+            }
+        }
+
+        if(std::rename(temporaryFilePath.c_str(), _filePath.c_str()) == 0)
+        {
+            return true;
+        }
+
+        // Some platforms can't rename a file over an existing one:
+        std::remove(_filePath.c_str());
+        return std::rename(temporaryFilePath.c_str(), _filePath.c_str()) == 0;
+    }
+
+    /**
+     * @brief Loads an optimization state from the checkpoint file.
+     * @param state Output optimization state.
+     * @param userData If it is not null, it contains the arbitrary data stored with the optimization state.
+     * @return true if the checkpoint file exists and it has been read successfully, otherwise false.
+     */
+    bool load(State& state, std::vector<char>* userData = nullptr)
+    {
+        std::ifstream file(_filePath, std::ios::binary);
+
+        if(! file)
+        {
+            return false;
+        }
+
+        _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        const char* data = _buffer.data();
+        const char* dataEnd = data + _buffer.size();
+        std::vector<char> readUserData;
+
+        if(! read(data, dataEnd, state) || ! Serializer<std::vector<char>>::read(data, dataEnd, readUserData))
+        {
+            return false;
+        }
+
+        if(userData)
+        {
+            userData->swap(readUserData);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief optimize Minimizes the loss function with the given solution, saving the optimization state
+     * periodically in the checkpoint file.
+     *
+     * If the checkpoint file contains a valid optimization state, the optimization process is resumed from it
+     * and the given solution is ignored.
+     *
+     * The checkpoint file is removed when the optimization process finishes, so later calls optimize
+     * the given solution instead of resuming the finished process. If a checkpoint can't be saved,
+     * the optimization process goes on and hasSaveFailed returns true.
+     *
+     * @param vns Variable neighborhood search object (VNS, SpeculativeVNS, etc).
+     * @param solution The solution to optimize.
+     * @param checkpointIterations Number of local searches applied between checkpoints.
+     * @param optimized Output parameter which indicates if the input solution has been optimized or not.
+     * @return The optimized solution.
+     */
+    template<class VNSType, class SolutionType>
+    Solution optimize(VNSType& vns, SolutionType&& solution, int checkpointIterations, bool& optimized)
+    {
+        HIKE_ASSERT(checkpointIterations > 0);
+
+        State state = State();
+        _saveFailed = false;
+
+        if(! load(state))
+        {
+            state = vns.createState(std::forward<SolutionType>(solution));
+        }
+
+        while(! vns.iterate(state, checkpointIterations))
+        {
+            if(! save(state))
+            {
+                _saveFailed = true;
+            }
+        }
+
+        std::remove(_filePath.c_str());
+        optimized = state.optimized;
+        return std::move(state.solution);
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    using ScheduleState = decltype(std::declval<State&>().scheduleState);
+
+    static constexpr std::uint32_t _magic = 0x53564e48; // "HNVS"
+
+    std::string _filePath;
+    std::vector<char> _buffer;
+    bool _saveFailed;
+
+    ///@endcond
+};
+
+///@cond INTERNAL
+
+template<class Solution, class VNS, class SolutionSerializer, class LossSerializer>
+constexpr std::uint32_t VNSCheckpoint<Solution, VNS, SolutionSerializer, LossSerializer>::_magic;
+
+///@endcond
+
+}
+
+#endif
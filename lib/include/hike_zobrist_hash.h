@@ -0,0 +1,119 @@
+// Copyright (c) 2018 Gustavo Valiente gustavo.valiente.m@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+
+#ifndef HIKE_ZOBRIST_HASH_H
+#define HIKE_ZOBRIST_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include "hike_solution_hash.h"
+
+namespace hike
+{
+
+/**
+ * @brief Solution hash which can be updated in constant time when a single parameter changes.
+ *
+ * The hash of a solution is the XOR of a pseudo-random key per parameter index and value,
+ * as in Zobrist hashing, but keys are calculated on the fly instead of stored in a table.
+ *
+ * Solutions must be containers of arithmetic parameters with size() and operator[] methods.
+ *
+ * https://en.wikipedia.org/wiki/Zobrist_hashing
+ */
+template<class Solution>
+class ZobristHash
+{
+
+public:
+    /**
+     * @brief Returns the hash of the given solution.
+     */
+    std::size_t operator()(const Solution& solution) const noexcept
+    {
+        std::size_t hash = 0;
+
+        for(std::size_t paramIndex = 0, size = solution.size(); paramIndex < size; ++paramIndex)
+        {
+            hash ^= getParamKey(paramIndex, solution[paramIndex]);
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Returns the key of the given parameter index and value.
+     */
+    template<class Param>
+    static std::size_t getParamKey(std::size_t paramIndex, const Param& param) noexcept
+    {
+        return std::size_t(_mix(_mix(std::uint64_t(paramIndex) + 1) ^ _ParamsHasher::word(param)));
+    }
+
+    /**
+     * @brief Returns the hash of a solution after changing one of its parameters.
+     * @param hash Hash of the solution before the change.
+     * @param paramIndex Index of the changed parameter.
+     * @param oldParam Parameter value before the change.
+     * @param newParam Parameter value after the change.
+     */
+    template<class Param>
+    static std::size_t update(std::size_t hash, std::size_t paramIndex, const Param& oldParam,
+                              const Param& newParam) noexcept
+    {
+        return hash ^ getParamKey(paramIndex, oldParam) ^ getParamKey(paramIndex, newParam);
+    }
+
+protected:
+    ///@cond INTERNAL
+
+    static std::uint64_t _mix(std::uint64_t value) noexcept
+    {
+        // SplitMix64 finalizer:
+
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    ///@endcond
+};
+
+/**
+ * @brief Solution with its ZobristHash, which local searches keep updated as they change parameters.
+ *
+ * Loss functions which receive it can look solutions up without hashing them (see HasHashedLoss).
+ */
+template<class Solution>
+struct HashedSolution
+{
+    /**
+     * @brief Solution parameters.
+     */
+    const Solution& solution;
+
+    /**
+     * @brief ZobristHash of the solution.
+     */
+    std::size_t hash;
+};
+
+}
+
+#endif
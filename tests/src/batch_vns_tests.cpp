@@ -0,0 +1,100 @@
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_vns.h"
+#include "hike_batch_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    struct LossFunction
+    {
+        Solution targetSolution;
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - targetSolution[i]);
+            }
+
+            return loss;
+        }
+    };
+
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    using VNS = hike::VNS<Solution, LocalSearch>;
+    using BatchVNS = hike::BatchVNS<Solution, VNS>;
+
+    VNS createVNS(const Solution& targetSolution)
+    {
+        Solution stepSolution{{ 1, 1, 1 }};
+        return VNS(LocalSearch(LossFunction{ targetSolution }, stepSolution), 2);
+    }
+
+    std::vector<Solution> createSolutions()
+    {
+        std::vector<Solution> solutions;
+
+        for(int p = -50; p <= 50; ++p)
+        {
+            solutions.push_back(Solution{{ p, -p, p / 2 }});
+        }
+
+        return solutions;
+    }
+}
+
+TEST_CASE("BatchVNS optimize")
+{
+    Solution targetSolution{{ 3, -2, 5 }};
+    BatchVNS batchVNS(createVNS(targetSolution), 3);
+    batchVNS.setChunkSize(4);
+
+    std::vector<Solution> solutions = createSolutions();
+    std::vector<BatchVNS::Result> results(solutions.size());
+    batchVNS.optimize(solutions.begin(), solutions.end(), results.begin());
+
+    for(const BatchVNS::Result& result : results)
+    {
+        REQUIRE(result.solution == targetSolution);
+        REQUIRE(result.loss == 0);
+    }
+
+    // An empty batch does nothing:
+    batchVNS.optimize(solutions.begin(), solutions.begin(), results.begin());
+}
+
+TEST_CASE("BatchVNS optimize with params")
+{
+    BatchVNS batchVNS(createVNS(Solution{{ 0, 0, 0 }}), 3);
+    batchVNS.setChunkSize(1);
+
+    std::vector<Solution> solutions = createSolutions();
+    std::vector<Solution> targetSolutions;
+
+    for(const Solution& solution : solutions)
+    {
+        targetSolutions.push_back(Solution{{ solution[2], solution[0], solution[1] }});
+    }
+
+    std::vector<BatchVNS::Result> results(solutions.size());
+    batchVNS.optimize(solutions.begin(), solutions.end(), targetSolutions.begin(), results.begin(),
+                      [](VNS& vns, const Solution& targetSolution)
+    {
+        vns.getLocalSearch().getLossFunction().targetSolution = targetSolution;
+    });
+
+    for(std::size_t index = 0; index < solutions.size(); ++index)
+    {
+        const BatchVNS::Result& result = results[index];
+        REQUIRE(result.solution == targetSolutions[index]);
+        REQUIRE(result.loss == 0);
+        REQUIRE(result.optimized == (solutions[index] != targetSolutions[index]));
+    }
+}
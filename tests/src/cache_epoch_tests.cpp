@@ -0,0 +1,165 @@
+#include <vector>
+#include <catch.hpp>
+#include "hike_cached_loss_function.h"
+#include "hike_ts_cached_loss_function.h"
+
+namespace
+{
+    struct SolutionHash
+    {
+        std::size_t operator()(int solution) const
+        {
+            return std::hash<int>()(solution);
+        }
+    };
+
+    struct LossFunction
+    {
+        int* offset;
+        int* evaluations;
+
+        int operator()(int solution) const
+        {
+            ++*evaluations;
+            return solution + *offset;
+        }
+    };
+
+    template<class Cache>
+    void testEpochs()
+    {
+        int offset = 0;
+        int evaluations = 0;
+        Cache cache(LossFunction{ &offset, &evaluations });
+        REQUIRE(cache.getEpoch() == 1);
+
+        REQUIRE(cache(1) == 1);
+        REQUIRE(cache(1) == 1);
+        REQUIRE(evaluations == 1);
+
+        // Losses of previous epochs are not returned anymore:
+
+        offset = 10;
+        cache.nextEpoch();
+        REQUIRE(cache.getEpoch() == 2);
+
+        int hint = 0;
+        REQUIRE(cache.findHint(1, hint));
+        REQUIRE(hint == 1);
+        REQUIRE(! cache.findHint(2, hint));
+
+        REQUIRE(cache(1) == 11);
+        REQUIRE(evaluations == 2);
+        REQUIRE(cache.findHint(1, hint));
+        REQUIRE(hint == 11);
+
+        // Losses older than the previous epoch are reclaimed when new losses are cached:
+
+        REQUIRE(cache(2) == 12);
+        cache.nextEpoch();
+        cache.nextEpoch();
+        REQUIRE(! cache.findHint(1, hint));
+        REQUIRE(cache.getCachedLossesCount() == 2);
+
+        for(int solution = 100; solution < 104; ++solution)
+        {
+            cache(solution);
+        }
+
+        REQUIRE(cache.getCachedLossesCount() == 4);
+    }
+
+    template<class Cache>
+    void testSaveAndLoad()
+    {
+        int offset = 0;
+        int evaluations = 0;
+        Cache cache(LossFunction{ &offset, &evaluations });
+        cache(1);
+        cache.nextEpoch();
+        cache(2);
+        cache.nextEpoch();
+        cache(3);
+
+        std::vector<char> buffer;
+        cache.template save<>(buffer);
+
+        Cache loadedCache(LossFunction{ &offset, &evaluations });
+        const char* data = buffer.data();
+        REQUIRE(loadedCache.template load<>(data, data + buffer.size()));
+        REQUIRE(data == buffer.data() + buffer.size());
+        REQUIRE(loadedCache.getCachedLossesCount() == 2);
+
+        // Losses of the current epoch are returned, losses of the previous one are hints only:
+
+        evaluations = 0;
+        REQUIRE(loadedCache(3) == 3);
+        REQUIRE(evaluations == 0);
+
+        int hint = 0;
+        REQUIRE(loadedCache.findHint(2, hint));
+        REQUIRE(hint == 2);
+        REQUIRE(! loadedCache.findHint(1, hint));
+
+        REQUIRE(loadedCache(2) == 2);
+        REQUIRE(evaluations == 1);
+    }
+}
+
+TEST_CASE("CachedLossFunction epochs")
+{
+    testEpochs<hike::CachedLossFunction<int, LossFunction, SolutionHash>>();
+}
+
+TEST_CASE("TSCachedLossFunction epochs")
+{
+    testEpochs<hike::TSCachedLossFunction<int, LossFunction, SolutionHash>>();
+}
+
+TEST_CASE("CachedLossFunction epochs save and load")
+{
+    testSaveAndLoad<hike::CachedLossFunction<int, LossFunction, SolutionHash>>();
+}
+
+TEST_CASE("TSCachedLossFunction epochs save and load")
+{
+    testSaveAndLoad<hike::TSCachedLossFunction<int, LossFunction, SolutionHash>>();
+}
+
+TEST_CASE("CachedLossFunction epochs copy")
+{
+    using Cache = hike::CachedLossFunction<int, LossFunction, SolutionHash>;
+
+    int offset = 0;
+    int evaluations = 0;
+    Cache cache(LossFunction{ &offset, &evaluations });
+
+    for(int solution = 0; solution < 50; ++solution)
+    {
+        cache(solution);
+    }
+
+    cache.nextEpoch();
+    cache.nextEpoch();
+
+    // Each copy reclaims the stale losses of its own map:
+
+    Cache copy(cache);
+    Cache assigned(LossFunction{ &offset, &evaluations });
+    assigned = cache;
+    Cache temporary(cache);
+    Cache moved(std::move(temporary));
+
+    for(int solution = 100; solution < 200; ++solution)
+    {
+        cache(solution);
+        copy(solution);
+        assigned(solution);
+        moved(solution);
+    }
+
+    REQUIRE(cache.getCachedLossesCount() == 100);
+    REQUIRE(copy.getCachedLossesCount() == 100);
+    REQUIRE(assigned.getCachedLossesCount() == 100);
+    REQUIRE(moved.getCachedLossesCount() == 100);
+}
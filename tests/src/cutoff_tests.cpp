@@ -0,0 +1,146 @@
+#include <array>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_cached_loss_function.h"
+#include "hike_ts_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    class LossFunction
+    {
+
+    public:
+        explicit LossFunction(const Solution& targetSolution) noexcept :
+            _targetSolution(targetSolution)
+        {
+        }
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+        int operator()(const Solution& solution, int cutoff) const noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+
+                if(loss >= cutoff)
+                {
+                    break;
+                }
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+    };
+
+    template<class LocalSearch>
+    void testVNS(LocalSearch&& localSearch, const Solution& targetSolution)
+    {
+        hike::VNS<Solution, typename std::decay<LocalSearch>::type> vns(std::forward<LocalSearch>(localSearch), 3);
+
+        for(int p1 = -5; p1 <= 5; ++p1)
+        {
+            for(int p2 = -5; p2 <= 5; ++p2)
+            {
+                for(int p3 = -5; p3 <= 5; ++p3)
+                {
+                    Solution solution{{ p1, p2, p3 }};
+                    bool optimized;
+                    Solution optimizedSolution = vns.optimize(solution, optimized);
+                    REQUIRE(optimized == (solution != targetSolution));
+                    REQUIRE(optimizedSolution == targetSolution);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("HasCutoff test")
+{
+    using CachedLossFunction = hike::CachedLossFunction<Solution, LossFunction>;
+    REQUIRE(hike::HasCutoff<LossFunction, Solution>::value);
+    REQUIRE(hike::HasCutoff<CachedLossFunction, Solution>::value);
+    REQUIRE(! hike::HasCutoff<hike::SolutionHash<Solution>, Solution>::value);
+}
+
+TEST_CASE("CachedLossFunction with cutoff test")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    hike::CachedLossFunction<Solution, LossFunction> cachedLossFunction((LossFunction(targetSolution)));
+    Solution solution{{ 12, 5, 0 }};
+
+    // Cutoff exceeded, so a lower bound is returned and cached:
+    REQUIRE(cachedLossFunction(solution, 5) == 10);
+    REQUIRE(cachedLossFunction(solution, 8) == 10);
+
+    // Cached lower bound is lower than the cutoff, so the loss is calculated again:
+    REQUIRE(cachedLossFunction(solution, 15) == 20);
+
+    // Exact losses are always returned:
+    REQUIRE(cachedLossFunction(solution) == 20);
+    REQUIRE(cachedLossFunction(solution, 5) == 20);
+
+    Solution otherSolution{{ 2, 15, -20 }};
+    REQUIRE(cachedLossFunction(otherSolution, 1) == 10);
+    REQUIRE(cachedLossFunction(otherSolution) == 20);
+}
+
+TEST_CASE("TSCachedLossFunction with cutoff test")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    hike::TSCachedLossFunction<Solution, LossFunction> cachedLossFunction((LossFunction(targetSolution)));
+    Solution solution{{ 12, 5, 0 }};
+    REQUIRE(cachedLossFunction(solution, 5) == 10);
+    REQUIRE(cachedLossFunction(solution, 8) == 10);
+    REQUIRE(cachedLossFunction(solution, 15) == 20);
+    REQUIRE(cachedLossFunction(solution) == 20);
+    REQUIRE(cachedLossFunction(solution, 5) == 20);
+}
+
+TEST_CASE("FILocalSearch VNS with cutoff")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using CachedLossFunction = hike::CachedLossFunction<Solution, LossFunction>;
+    using LocalSearch = hike::FILocalSearch<Solution, CachedLossFunction>;
+    testVNS(LocalSearch(CachedLossFunction(LossFunction(targetSolution)), stepSolution), targetSolution);
+}
+
+TEST_CASE("BILocalSearch VNS with cutoff")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using CachedLossFunction = hike::CachedLossFunction<Solution, LossFunction>;
+    using LocalSearch = hike::BILocalSearch<Solution, CachedLossFunction>;
+    testVNS(LocalSearch(CachedLossFunction(LossFunction(targetSolution)), stepSolution), targetSolution);
+}
+
+TEST_CASE("ParallelBILocalSearch VNS with cutoff")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using CachedLossFunction = hike::TSCachedLossFunction<Solution, LossFunction>;
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, CachedLossFunction>;
+    testVNS(LocalSearch(CachedLossFunction(LossFunction(targetSolution)), stepSolution), targetSolution);
+}
@@ -0,0 +1,87 @@
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_vns.h"
+#include "hike_island_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    class LossFunction
+    {
+
+    public:
+        explicit LossFunction(const Solution& targetSolution) noexcept :
+            _targetSolution(targetSolution)
+        {
+        }
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+    };
+
+    template<class LocalSearch>
+    void testIslandVNS(const LocalSearch& localSearch, const Solution& targetSolution)
+    {
+        using VNS = hike::VNS<Solution, LocalSearch>;
+
+        for(int migrationIterations = 1; migrationIterations < 20; migrationIterations += 6)
+        {
+            hike::IslandVNS<Solution, VNS> islandVNS(VNS(localSearch, 2), migrationIterations);
+
+            for(std::size_t islands = 1; islands <= 4; ++islands)
+            {
+                std::vector<Solution> solutions;
+
+                for(std::size_t island = 0; island < islands; ++island)
+                {
+                    int p = int(island) * 7;
+                    solutions.push_back(Solution{{ p - 10, 20 - p, p * 2 }});
+                }
+
+                bool optimized;
+                Solution optimizedSolution = islandVNS.optimize(solutions, optimized);
+                REQUIRE(optimized);
+                REQUIRE(optimizedSolution == targetSolution);
+            }
+
+            std::vector<Solution> solutions(3, targetSolution);
+            bool optimized;
+            Solution optimizedSolution = islandVNS.optimize(solutions, optimized);
+            REQUIRE(! optimized);
+            REQUIRE(optimizedSolution == targetSolution);
+        }
+    }
+}
+
+TEST_CASE("FILocalSearch IslandVNS")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    testIslandVNS(LocalSearch(LossFunction(targetSolution), stepSolution), targetSolution);
+}
+
+TEST_CASE("BILocalSearch IslandVNS")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using LocalSearch = hike::BILocalSearch<Solution, LossFunction>;
+    testIslandVNS(LocalSearch(LossFunction(targetSolution), stepSolution), targetSolution);
+}
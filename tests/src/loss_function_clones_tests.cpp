@@ -0,0 +1,111 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    // Loss function which is not thread safe, since it uses a scratch buffer:
+    class LossFunction
+    {
+
+    public:
+        LossFunction(const Solution& targetSolution, std::atomic<int>& clones, std::atomic<int>& concurrentCalls) :
+            _targetSolution(targetSolution),
+            _clones(clones),
+            _concurrentCalls(concurrentCalls),
+            _calls(0)
+        {
+        }
+
+        LossFunction(const LossFunction& other) :
+            LossFunction(other._targetSolution, other._clones, other._concurrentCalls)
+        {
+        }
+
+        LossFunction clone() const
+        {
+            ++_clones;
+            return LossFunction(_targetSolution, _clones, _concurrentCalls);
+        }
+
+        int operator()(const Solution& solution)
+        {
+            if(++_calls > 1)
+            {
+                ++_concurrentCalls;
+            }
+
+            _diffs.clear();
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                _diffs.push_back(std::abs(solution[i] - _targetSolution[i]));
+            }
+
+            int loss = 0;
+
+            for(int diff : _diffs)
+            {
+                loss += diff;
+            }
+
+            --_calls;
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        std::atomic<int>& _clones;
+        std::atomic<int>& _concurrentCalls;
+        std::atomic<int> _calls;
+        std::vector<int> _diffs;
+    };
+}
+
+TEST_CASE("HasClone test")
+{
+    struct CopyableLossFunction
+    {
+        int operator()(const Solution&) const
+        {
+            return 0;
+        }
+    };
+
+    REQUIRE(hike::HasClone<LossFunction>::value);
+    REQUIRE(! hike::HasClone<CopyableLossFunction>::value);
+}
+
+TEST_CASE("Loss function clones test")
+{
+    using Evaluator = hike::ThreadPoolEvaluator<Solution, LossFunction>;
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction>;
+
+    Solution targetSolution{{ 2, -3, 1 }};
+    std::atomic<int> clones(0);
+    std::atomic<int> concurrentCalls(0);
+    LocalSearch localSearch(LossFunction(targetSolution, clones, concurrentCalls), Solution{{ 1, 1, 1 }});
+    localSearch.getEvaluator() = Evaluator(3);
+    localSearch.getEvaluator().setLossFunctionClonesEnabled(true);
+    REQUIRE(localSearch.getEvaluator().isLossFunctionClonesEnabled());
+
+    hike::VNS<Solution, LocalSearch> vns(std::move(localSearch), 3);
+
+    for(int p1 = -4; p1 <= 4; ++p1)
+    {
+        for(int p2 = -4; p2 <= 4; ++p2)
+        {
+            bool optimized;
+            Solution solution = vns.optimize(Solution{{ p1, p2, 0 }}, optimized);
+            REQUIRE(solution == targetSolution);
+        }
+    }
+
+    REQUIRE(clones == 3);
+    REQUIRE(concurrentCalls == 0);
+}
@@ -0,0 +1,150 @@
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <catch.hpp>
+#include "hike_loss_kernels.h"
+#include "hike_fi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    template<class Value>
+    std::vector<Value> createParams(std::mt19937& random, std::size_t count, Value min, Value max)
+    {
+        std::uniform_real_distribution<Value> distribution(min, max);
+        std::vector<Value> params(count);
+
+        for(Value& param : params)
+        {
+            param = distribution(random);
+        }
+
+        return params;
+    }
+
+    template<class Value>
+    bool equal(Value a, Value b)
+    {
+        return std::abs(a - b) <= Value(1e-4) * (Value(1) + std::abs(a) + std::abs(b));
+    }
+
+    template<class Value>
+    void testKernels()
+    {
+        using Kernels = hike::LossKernels<Value>;
+        using ScalarKernels = hike::ScalarLossKernels<Value>;
+
+        std::mt19937 random(1234);
+
+        for(std::size_t paramsCount = 1; paramsCount <= 19; ++paramsCount)
+        {
+            auto targetParams = createParams<Value>(random, paramsCount, -10, 10);
+            auto weights = createParams<Value>(random, paramsCount, 0, 2);
+            auto lowerBounds = createParams<Value>(random, paramsCount, -5, 0);
+            auto upperBounds = createParams<Value>(random, paramsCount, 0, 5);
+            auto upperSlopes = createParams<Value>(random, paramsCount, 0, 3);
+            auto matrix = createParams<Value>(random, paramsCount * paramsCount, -1, 1);
+
+            for(std::size_t solutionsCount = 0; solutionsCount <= 13; ++solutionsCount)
+            {
+                std::vector<std::vector<Value>> solutions;
+                std::vector<const Value*> solutionPointers;
+
+                for(std::size_t index = 0; index < solutionsCount; ++index)
+                {
+                    solutions.push_back(createParams<Value>(random, paramsCount, -10, 10));
+                    solutionPointers.push_back(solutions.back().data());
+                }
+
+                std::vector<Value> l1Losses(solutionsCount);
+                std::vector<Value> l2Losses(solutionsCount);
+                std::vector<Value> quadraticLosses(solutionsCount);
+                std::vector<Value> penaltyLosses(solutionsCount);
+                Kernels::weightedL1(solutionPointers.data(), solutionsCount, targetParams.data(), weights.data(),
+                                    paramsCount, l1Losses.data());
+                Kernels::weightedL2(solutionPointers.data(), solutionsCount, targetParams.data(), weights.data(),
+                                    paramsCount, l2Losses.data());
+                Kernels::quadraticForm(solutionPointers.data(), solutionsCount, matrix.data(), targetParams.data(),
+                                       paramsCount, quadraticLosses.data());
+                Kernels::piecewiseLinear(solutionPointers.data(), solutionsCount, lowerBounds.data(),
+                                         upperBounds.data(), weights.data(), upperSlopes.data(), paramsCount,
+                                         penaltyLosses.data());
+
+                for(std::size_t index = 0; index < solutionsCount; ++index)
+                {
+                    const Value* params = solutions[index].data();
+
+                    Value l1Loss = ScalarKernels::weightedL1(params, targetParams.data(), weights.data(),
+                                                             paramsCount);
+                    REQUIRE(equal(l1Loss, Kernels::weightedL1(params, targetParams.data(), weights.data(),
+                                                              paramsCount)));
+                    REQUIRE(equal(l1Loss, l1Losses[index]));
+
+                    Value l2Loss = ScalarKernels::weightedL2(params, targetParams.data(), weights.data(),
+                                                             paramsCount);
+                    REQUIRE(equal(l2Loss, Kernels::weightedL2(params, targetParams.data(), weights.data(),
+                                                              paramsCount)));
+                    REQUIRE(equal(l2Loss, l2Losses[index]));
+
+                    Value quadraticLoss = ScalarKernels::quadraticForm(params, matrix.data(), targetParams.data(),
+                                                                       paramsCount);
+                    REQUIRE(equal(quadraticLoss, Kernels::quadraticForm(params, matrix.data(), targetParams.data(),
+                                                                        paramsCount)));
+                    REQUIRE(equal(quadraticLoss, quadraticLosses[index]));
+
+                    Value penaltyLoss = ScalarKernels::piecewiseLinear(params, lowerBounds.data(), upperBounds.data(),
+                                                                       weights.data(), upperSlopes.data(),
+                                                                       paramsCount);
+                    REQUIRE(equal(penaltyLoss, Kernels::piecewiseLinear(params, lowerBounds.data(),
+                                                                        upperBounds.data(), weights.data(),
+                                                                        upperSlopes.data(), paramsCount)));
+                    REQUIRE(equal(penaltyLoss, penaltyLosses[index]));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Loss kernels float")
+{
+    testKernels<float>();
+}
+
+TEST_CASE("Loss kernels double")
+{
+    testKernels<double>();
+}
+
+TEST_CASE("Loss functions")
+{
+    using Solution = std::array<double, 3>;
+
+    hike::WeightedL1Loss<double> l1Loss({ 1, 2, 3 }, { 1, 2, 3 });
+    REQUIRE(l1Loss(Solution{{ 0, 0, 0 }}) == 14);
+
+    hike::WeightedL2Loss<double> l2Loss({ 1, 2, 3 });
+    REQUIRE(l2Loss(Solution{{ 0, 0, 0 }}) == 14);
+
+    hike::QuadraticFormLoss<double> quadraticLoss({ 1, 0, 0, 0, 2, 0, 0, 0, 3 }, { 1, 1, 1 });
+    REQUIRE(quadraticLoss(Solution{{ 1, 1, 2 }}) == 19);
+
+    hike::PiecewiseLinearPenaltyLoss<double> penaltyLoss({ 0, 0, 0 }, { 1, 1, 1 }, { 2, 2, 2 }, { 3, 3, 3 });
+    REQUIRE(penaltyLoss(Solution{{ -1, 0.5, 3 }}) == 8);
+
+    std::vector<Solution> solutions{ Solution{{ 0, 0, 0 }}, Solution{{ 1, 2, 3 }}, Solution{{ 2, 2, 2 }} };
+    std::vector<double> losses;
+    l1Loss.evaluate(solutions.begin(), solutions.end(), std::back_inserter(losses));
+    REQUIRE(losses == std::vector<double>({ 14, 0, 4 }));
+}
+
+TEST_CASE("Loss functions VNS")
+{
+    using Solution = std::array<int, 3>;
+    using LossFunction = hike::WeightedL1Loss<int>;
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+
+    Solution stepSolution{{ 1, 1, 1 }};
+    hike::VNS<Solution, LocalSearch> vns(LocalSearch(LossFunction({ 3, -2, 5 }, { 1, 2, 3 }), stepSolution), 2);
+    REQUIRE(vns.optimize(Solution{{ 0, 0, 0 }}) == Solution({{ 3, -2, 5 }}));
+}
@@ -0,0 +1,120 @@
+#include <array>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 4>;
+
+    class LossFunction
+    {
+
+    public:
+        LossFunction(const Solution& targetSolution, int& evaluations) noexcept :
+            _targetSolution(targetSolution),
+            _evaluations(&evaluations)
+        {
+        }
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            ++*_evaluations;
+            return lowerBound(solution, solution.size() - 1);
+        }
+
+        int lowerBound(const Solution& solution, std::size_t paramIndex) const noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0; i <= paramIndex; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        int* _evaluations;
+    };
+
+    struct UnboundedLossFunction
+    {
+        LossFunction lossFunction;
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            return lossFunction(solution);
+        }
+    };
+
+    template<class LocalSearch, class UnboundedLocalSearch>
+    void testVNS(const LocalSearch& localSearch, const UnboundedLocalSearch& unboundedLocalSearch,
+                 const Solution& targetSolution, const int& evaluations)
+    {
+        for(int k = 1; k < 4; ++k)
+        {
+            hike::VNS<Solution, LocalSearch> vns(localSearch, k);
+            hike::VNS<Solution, UnboundedLocalSearch> unboundedVNS(unboundedLocalSearch, k);
+
+            for(int p = -5; p <= 5; ++p)
+            {
+                Solution solution{{ p, -p, p * 2, 1 }};
+                int unboundedEvaluations = evaluations;
+                Solution unboundedOptimizedSolution = unboundedVNS.optimize(solution);
+                unboundedEvaluations = evaluations - unboundedEvaluations;
+
+                int boundedEvaluations = evaluations;
+                bool optimized;
+                Solution optimizedSolution = vns.optimize(solution, optimized);
+                boundedEvaluations = evaluations - boundedEvaluations;
+
+                REQUIRE(optimized == (solution != targetSolution));
+                REQUIRE(optimizedSolution == targetSolution);
+                REQUIRE(unboundedOptimizedSolution == optimizedSolution);
+                REQUIRE(boundedEvaluations < unboundedEvaluations);
+            }
+        }
+    }
+}
+
+TEST_CASE("HasLowerBound test")
+{
+    using CachedLossFunction = hike::CachedLossFunction<Solution, LossFunction>;
+    using UnboundedCachedLossFunction = hike::CachedLossFunction<Solution, UnboundedLossFunction>;
+    REQUIRE(hike::HasLowerBound<LossFunction, Solution>::value);
+    REQUIRE(hike::HasLowerBound<CachedLossFunction, Solution>::value);
+    REQUIRE(! hike::HasLowerBound<UnboundedLossFunction, Solution>::value);
+    REQUIRE(! hike::HasLowerBound<UnboundedCachedLossFunction, Solution>::value);
+}
+
+TEST_CASE("FILocalSearch VNS with lower bounds")
+{
+    int evaluations = 0;
+    Solution targetSolution{{ 2, 5, -10, 1 }};
+    Solution stepSolution{{ 1, 1, 1, 1 }};
+    LossFunction lossFunction(targetSolution, evaluations);
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    using UnboundedLocalSearch = hike::FILocalSearch<Solution, UnboundedLossFunction>;
+    LocalSearch localSearch(lossFunction, stepSolution);
+    UnboundedLocalSearch unboundedLocalSearch(UnboundedLossFunction{lossFunction}, stepSolution);
+    testVNS(localSearch, unboundedLocalSearch, targetSolution, evaluations);
+}
+
+TEST_CASE("BILocalSearch VNS with lower bounds")
+{
+    int evaluations = 0;
+    Solution targetSolution{{ 2, 5, -10, 1 }};
+    Solution stepSolution{{ 1, 1, 1, 1 }};
+    LossFunction lossFunction(targetSolution, evaluations);
+    using LocalSearch = hike::BILocalSearch<Solution, LossFunction>;
+    using UnboundedLocalSearch = hike::BILocalSearch<Solution, UnboundedLossFunction>;
+    LocalSearch localSearch(lossFunction, stepSolution);
+    UnboundedLocalSearch unboundedLocalSearch(UnboundedLossFunction{lossFunction}, stepSolution);
+    testVNS(localSearch, unboundedLocalSearch, targetSolution, evaluations);
+}
@@ -0,0 +1,128 @@
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_ts_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_vns.h"
+#include "hike_multi_start_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    class LossFunction
+    {
+
+    public:
+        LossFunction(const Solution& targetSolution, std::atomic<int>& evaluations) noexcept :
+            _targetSolution(targetSolution),
+            _evaluations(&evaluations)
+        {
+        }
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            int loss = 0;
+            ++*_evaluations;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        std::atomic<int>* _evaluations;
+    };
+
+    using CachedLossFunction = hike::TSCachedLossFunction<Solution, LossFunction>;
+    using LocalSearch = hike::FILocalSearch<Solution, CachedLossFunction>;
+    using VNS = hike::VNS<Solution, LocalSearch>;
+    using MultiStartVNS = hike::MultiStartVNS<Solution, VNS>;
+
+    VNS createVNS(const Solution& targetSolution, std::atomic<int>& evaluations)
+    {
+        Solution stepSolution{{ 1, 1, 1 }};
+        CachedLossFunction cachedLossFunction(LossFunction(targetSolution, evaluations));
+        return VNS(LocalSearch(std::move(cachedLossFunction), stepSolution), 2);
+    }
+
+    std::vector<Solution> createSolutions()
+    {
+        std::vector<Solution> solutions;
+
+        for(int p = -30; p <= 30; p += 3)
+        {
+            solutions.push_back(Solution{{ p, -p, p / 2 }});
+        }
+
+        return solutions;
+    }
+}
+
+TEST_CASE("MultiStartVNS test")
+{
+    std::atomic<int> evaluations(0);
+    Solution targetSolution{{ 2, 5, -10 }};
+    MultiStartVNS multiStartVNS(createVNS(targetSolution, evaluations));
+    std::vector<Solution> solutions = createSolutions();
+    std::vector<MultiStartVNS::Result> results;
+    Solution optimizedSolution = multiStartVNS.optimize(solutions, results);
+    REQUIRE(optimizedSolution == targetSolution);
+    REQUIRE(results.size() == solutions.size());
+
+    for(const MultiStartVNS::Result& result : results)
+    {
+        REQUIRE(result.optimized);
+        REQUIRE(! result.cancelled);
+        REQUIRE(result.solution == targetSolution);
+        REQUIRE(result.loss == 0);
+    }
+}
+
+TEST_CASE("MultiStartVNS shared cache test")
+{
+    std::atomic<int> evaluations(0);
+    Solution targetSolution{{ 2, 5, -10 }};
+    MultiStartVNS multiStartVNS(createVNS(targetSolution, evaluations), 1);
+    std::vector<Solution> solutions(1, Solution{{ 20, -20, 20 }});
+    REQUIRE(multiStartVNS.optimize(solutions) == targetSolution);
+
+    int singleStartEvaluations = evaluations;
+    solutions.resize(8, solutions[0]);
+    REQUIRE(multiStartVNS.optimize(solutions) == targetSolution);
+    REQUIRE(evaluations == singleStartEvaluations);
+}
+
+TEST_CASE("MultiStartVNS dominated starts test")
+{
+    std::atomic<int> evaluations(0);
+    Solution targetSolution{{ 2, 5, -10 }};
+    MultiStartVNS multiStartVNS(createVNS(targetSolution, evaluations), 1);
+    multiStartVNS.setDominatedIterations(2);
+
+    std::vector<Solution> solutions = createSolutions();
+    std::vector<MultiStartVNS::Result> results;
+    Solution optimizedSolution = multiStartVNS.optimize(solutions, results);
+    REQUIRE(optimizedSolution == targetSolution);
+    REQUIRE(! results[0].cancelled);
+    REQUIRE(results[0].solution == targetSolution);
+
+    std::size_t cancelledStarts = 0;
+
+    for(std::size_t index = 1; index < results.size(); ++index)
+    {
+        const MultiStartVNS::Result& result = results[index];
+        cancelledStarts += result.cancelled;
+        REQUIRE(result.cancelled == (result.solution != targetSolution));
+        REQUIRE(result.loss == std::abs(result.solution[0] - 2) + std::abs(result.solution[1] - 5) +
+                std::abs(result.solution[2] + 10));
+    }
+
+    REQUIRE(cancelledStarts > 0);
+}
@@ -0,0 +1,199 @@
+#include <vector>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_vns.h"
+#include "hike_bandit_neighborhood_schedules.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    struct LossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            int loss = 0;
+
+            for(int value : solution)
+            {
+                loss += value * value;
+            }
+
+            return loss;
+        }
+    };
+
+    // Local search which never optimizes, recording the neighborhoods it is asked for:
+    class RecordingLocalSearch
+    {
+
+    public:
+        LossFunction& getLossFunction()
+        {
+            return _lossFunction;
+        }
+
+        void setNeighborhood(int k)
+        {
+            neighborhoods.push_back(k);
+        }
+
+        Solution optimize(const Solution& solution, bool& optimized)
+        {
+            optimized = false;
+            return solution;
+        }
+
+        std::vector<int> neighborhoods;
+
+    private:
+        LossFunction _lossFunction;
+    };
+
+    template<class Schedule>
+    std::vector<int> walk(const Schedule& schedule, int kmax, const std::vector<bool>& improvements)
+    {
+        typename Schedule::State state;
+        std::vector<int> neighborhoods;
+        std::size_t index = 0;
+
+        for(int k = schedule.first(state, kmax); k <= kmax; ++index)
+        {
+            neighborhoods.push_back(k);
+            bool improved = index < improvements.size() && improvements[index];
+            k = schedule.next(state, hike::NeighborhoodResult{ k, improved, improved ? 1.0 : 0.0, 1 }, kmax);
+        }
+
+        return neighborhoods;
+    }
+}
+
+TEST_CASE("Linear neighborhood schedule test")
+{
+    hike::LinearNeighborhoodSchedule schedule;
+    REQUIRE(walk(schedule, 4, {}) == std::vector<int>({ 1, 2, 3, 4 }));
+    REQUIRE(walk(schedule, 4, { false, false, true }) == std::vector<int>({ 1, 2, 3, 1, 2, 3, 4 }));
+
+    schedule.setResetToPreviousEnabled(true);
+    REQUIRE(schedule.isResetToPreviousEnabled());
+    REQUIRE(walk(schedule, 4, { false, false, true }) == std::vector<int>({ 1, 2, 3, 2, 3, 4 }));
+}
+
+TEST_CASE("Geometric neighborhood schedule test")
+{
+    hike::GeometricNeighborhoodSchedule schedule;
+    REQUIRE(schedule.getFactor() == 2);
+    REQUIRE(walk(schedule, 1, {}) == std::vector<int>({ 1 }));
+    REQUIRE(walk(schedule, 8, {}) == std::vector<int>({ 1, 2, 4, 8 }));
+    REQUIRE(walk(schedule, 10, {}) == std::vector<int>({ 1, 2, 4, 8, 10 }));
+    REQUIRE(walk(schedule, 10, { false, true }) == std::vector<int>({ 1, 2, 1, 2, 4, 8, 10 }));
+
+    schedule.setFactor(1.5);
+    REQUIRE(walk(schedule, 10, {}) == std::vector<int>({ 1, 2, 3, 4, 6, 9, 10 }));
+
+    schedule.setResetToPreviousEnabled(true);
+    REQUIRE(walk(schedule, 10, { false, false, false, true }) ==
+            std::vector<int>({ 1, 2, 3, 4, 3, 4, 6, 9, 10 }));
+}
+
+TEST_CASE("Sequence neighborhood schedule test")
+{
+    hike::SequenceNeighborhoodSchedule schedule({ 1, 3, 7, 20 });
+    REQUIRE(walk(schedule, 30, {}) == std::vector<int>({ 1, 3, 7, 20 }));
+    REQUIRE(walk(schedule, 10, {}) == std::vector<int>({ 1, 3, 7 }));
+    REQUIRE(walk(schedule, 10, { false, true }) == std::vector<int>({ 1, 3, 1, 3, 7 }));
+}
+
+TEST_CASE("VNS neighborhood schedule test")
+{
+    using VNS = hike::VNS<Solution, RecordingLocalSearch, hike::EmptyOnImprovedSolution,
+                          hike::GeometricNeighborhoodSchedule>;
+    VNS vns(RecordingLocalSearch(), 20, hike::EmptyOnImprovedSolution(), hike::GeometricNeighborhoodSchedule(3));
+    REQUIRE(vns.getNeighborhoodSchedule().getFactor() == 3);
+
+    bool optimized;
+    vns.optimize(Solution{ 1, 2 }, optimized);
+    REQUIRE(! optimized);
+    REQUIRE(vns.getLocalSearch().neighborhoods == std::vector<int>({ 1, 3, 9, 20 }));
+}
+
+TEST_CASE("VNS geometric neighborhood schedule optimization test")
+{
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    using VNS = hike::VNS<Solution, LocalSearch, hike::EmptyOnImprovedSolution, hike::GeometricNeighborhoodSchedule>;
+    VNS vns(LocalSearch(LossFunction(), Solution{ 1, 1, 1 }), 3, hike::EmptyOnImprovedSolution(),
+            hike::GeometricNeighborhoodSchedule());
+
+    bool optimized;
+    Solution solution = vns.optimize(Solution{ 5, -4, 7 }, optimized);
+    REQUIRE(optimized);
+    REQUIRE(solution == Solution({ 0, 0, 0 }));
+}
+
+namespace
+{
+    template<class Schedule>
+    std::vector<int> walkRewards(const Schedule& schedule, int kmax, int improvingK, int improvements)
+    {
+        typename Schedule::State state;
+        std::vector<int> neighborhoods;
+
+        for(int k = schedule.first(state, kmax); k <= kmax; )
+        {
+            neighborhoods.push_back(k);
+
+            bool improved = k == improvingK && improvements-- > 0;
+            k = schedule.next(state, hike::NeighborhoodResult{ k, improved, improved ? 10.0 : 0.0, 5 }, kmax);
+        }
+
+        return neighborhoods;
+    }
+
+    template<class Schedule>
+    void testBanditSchedule(const Schedule& schedule)
+    {
+        // All neighborhoods are tried before finishing:
+        REQUIRE(walkRewards(schedule, 4, 0, 0) == std::vector<int>({ 1, 2, 3, 4 }));
+
+        // The improving neighborhood is selected again while it keeps improving:
+        REQUIRE(walkRewards(schedule, 3, 3, 3) == std::vector<int>({ 1, 2, 3, 3, 3, 3, 1, 2 }));
+
+        using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+        using VNS = hike::VNS<Solution, LocalSearch, hike::EmptyOnImprovedSolution, Schedule>;
+        VNS vns(LocalSearch(LossFunction(), Solution{ 1, 1, 1 }), 3, hike::EmptyOnImprovedSolution(), schedule);
+
+        bool optimized;
+        Solution solution = vns.optimize(Solution{ 5, -4, 7 }, optimized);
+        REQUIRE(optimized);
+        REQUIRE(solution == Solution({ 0, 0, 0 }));
+    }
+}
+
+TEST_CASE("UCB neighborhood schedule test")
+{
+    testBanditSchedule(hike::UCBNeighborhoodSchedule());
+}
+
+TEST_CASE("Epsilon-greedy neighborhood schedule test")
+{
+    testBanditSchedule(hike::EpsilonGreedyNeighborhoodSchedule(0));
+
+    hike::EpsilonGreedyNeighborhoodSchedule schedule(0.5, 1234);
+    REQUIRE(schedule.getSeed() == 1234);
+
+    std::vector<int> neighborhoods = walkRewards(schedule, 8, 2, 20);
+    REQUIRE(neighborhoods == walkRewards(schedule, 8, 2, 20));
+    REQUIRE(neighborhoods.size() > 20);
+}
+
+TEST_CASE("Local search evaluations count test")
+{
+    hike::FILocalSearch<Solution, LossFunction> localSearch(LossFunction(), Solution{ 1, 1 });
+    REQUIRE(localSearch.getEvaluationsCount() == 0);
+
+    localSearch.optimize(Solution{ 3, 3 });
+    REQUIRE(localSearch.getEvaluationsCount() > 0);
+
+    localSearch.resetEvaluationsCount();
+    REQUIRE(localSearch.getEvaluationsCount() == 0);
+}
@@ -0,0 +1,155 @@
+#include <catch.hpp>
+#include <atomic>
+#include "hike_numa_replicas.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+TEST_CASE("NumaTopology test")
+{
+    hike::NumaTopology topology;
+    REQUIRE(! topology.getNodes().empty());
+
+    for(const std::vector<int>& cpus : topology.getNodes())
+    {
+        REQUIRE(! cpus.empty());
+    }
+
+    const std::vector<int>& nodeIds = topology.getNodeIds();
+    REQUIRE(nodeIds.size() == topology.getNodes().size());
+    REQUIRE(nodeIds[0] >= 0);
+
+    for(std::size_t node = 1; node < nodeIds.size(); ++node)
+    {
+        REQUIRE(nodeIds[node] > nodeIds[node - 1]);
+    }
+}
+
+TEST_CASE("NumaTopology placements test")
+{
+    hike::NumaTopology topology({ { 0, 1 }, { 2, 3, 4 } });
+    std::vector<hike::ThreadPlacement> placements = topology.getPlacements(3);
+    REQUIRE(placements.size() == 6);
+
+    int expectedCpus[] = { 0, 1, 0, 2, 3, 4 };
+    int expectedNodes[] = { 0, 0, 0, 1, 1, 1 };
+
+    for(std::size_t index = 0; index < placements.size(); ++index)
+    {
+        REQUIRE(placements[index].cpu == expectedCpus[index]);
+        REQUIRE(placements[index].node == expectedNodes[index]);
+        REQUIRE(placements[index].nodeId == expectedNodes[index]);
+    }
+
+    REQUIRE(topology.getNodeIds() == std::vector<int>({ 0, 1 }));
+}
+
+TEST_CASE("Pinned ThreadPool test")
+{
+    struct Task
+    {
+        std::vector<int>& workerIndices;
+        std::vector<int>& workerNodes;
+        std::size_t index;
+
+        void operator()()
+        {
+            workerIndices[index] = hike::ThreadPoolWorker::getIndex();
+            workerNodes[index] = hike::ThreadPoolWorker::getNode();
+        }
+    };
+
+    hike::NumaTopology topology;
+    std::vector<hike::ThreadPlacement> placements = topology.getPlacements(2);
+    int threads = int(placements.size());
+    std::vector<int> workerIndices(1000, -1);
+    std::vector<int> workerNodes(1000, -1);
+    hike::ThreadPool<Task> threadPool(placements);
+
+    for(std::size_t index = 0; index < workerIndices.size(); ++index)
+    {
+        threadPool.add(Task{workerIndices, workerNodes, index});
+    }
+
+    threadPool.join();
+
+    for(std::size_t index = 0; index < workerIndices.size(); ++index)
+    {
+        int workerIndex = workerIndices[index];
+        REQUIRE(workerIndex >= 0);
+        REQUIRE(workerIndex < threads);
+        REQUIRE(workerNodes[index] == placements[std::size_t(workerIndex)].node);
+    }
+
+    REQUIRE(hike::ThreadPoolWorker::getIndex() == -1);
+    REQUIRE(hike::ThreadPoolWorker::getNode() == -1);
+    REQUIRE(! hike::ThreadPoolWorker::isPinned());
+}
+
+TEST_CASE("Unpinned ThreadPool test")
+{
+    struct Task
+    {
+        std::atomic<int>& pinnedTasks;
+
+        void operator()()
+        {
+            if(hike::ThreadPoolWorker::isPinned())
+            {
+                ++pinnedTasks;
+            }
+        }
+    };
+
+    // Threads without CPU or with an invalid one are not pinned, but they run tasks anyway:
+    std::vector<hike::ThreadPlacement> placements(2);
+    placements[1].cpu = 1 << 20;
+
+    std::atomic<int> pinnedTasks(0);
+    hike::ThreadPool<Task> threadPool(placements);
+
+    for(int index = 0; index < 100; ++index)
+    {
+        threadPool.add(Task{pinnedTasks});
+    }
+
+    threadPool.join();
+    REQUIRE(pinnedTasks == 0);
+}
+
+TEST_CASE("NumaReplicas test")
+{
+    hike::NumaReplicas<std::vector<int>> replicas(std::vector<int>{ 1, 2, 3 }, 2);
+    REQUIRE(replicas.getNodesCount() == 2);
+    REQUIRE(replicas.get().size() == 3);
+
+    struct LossFunction
+    {
+        const hike::NumaReplicas<std::vector<int>>& replicas;
+
+        int operator()(const std::vector<int>& solution) const
+        {
+            const std::vector<int>& weights = replicas.get();
+            int loss = 0;
+
+            for(std::size_t index = 0; index < solution.size(); ++index)
+            {
+                int diff = solution[index] - weights[index];
+                loss += diff * diff;
+            }
+
+            return loss;
+        }
+    };
+
+    hike::NumaTopology topology({ { 0 }, { 0 } });
+    using Evaluator = hike::ThreadPoolEvaluator<std::vector<int>, LossFunction>;
+    using LocalSearch = hike::ParallelBILocalSearch<std::vector<int>, LossFunction>;
+    LocalSearch localSearch(LossFunction{replicas}, std::vector<int>(3, 1));
+    localSearch.getEvaluator() = Evaluator(topology.getPlacements(1));
+
+    hike::VNS<std::vector<int>, LocalSearch> vns(std::move(localSearch), 4);
+    bool optimized;
+    std::vector<int> solution = vns.optimize(std::vector<int>(3, 0), optimized);
+    REQUIRE(optimized);
+    REQUIRE(solution == std::vector<int>({ 1, 2, 3 }));
+}
@@ -1,4 +1,5 @@
 #include <array>
+#include <cstdlib>
 #include <catch.hpp>
 #include "hike_fi_local_search.h"
 #include "hike_bi_local_search.h"
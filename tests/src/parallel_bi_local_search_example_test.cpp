@@ -1,4 +1,5 @@
 #include <array>
+#include <cstdlib>
 #include <catch.hpp>
 #include "hike_ts_cached_loss_function.h"
 #include "hike_parallel_bi_local_search.h"
@@ -9,26 +10,8 @@
 // Solution is a 3D integer vector. It can be of any type and size:
 using Solution = std::array<int, 3>;
 
-// CachedLossFunction uses std::hash to identify a solution, so it must be overloaded for the solution type:
-namespace std
-{
-    template<>
-    struct hash<Solution>
-    {
-        std::size_t operator()(const Solution& solution) const
-        {
-            std::size_t result = 0;
-
-            for(int param : solution)
-            {
-                // https://stackoverflow.com/questions/2590677/how-do-i-combine-hash-values-in-c0x:
-                result ^= std::hash<int>()(param) + 0x9e3779b9 + (result << 6) + (result >> 2);
-            }
-
-            return result;
-        }
-    };
-}
+// Loss caches identify solutions with hike::SolutionHash, which supports containers of arithmetic parameters
+// (other solution types need a std::hash specialization).
 
 TEST_CASE("ParallelBILocalSearch example")
 {
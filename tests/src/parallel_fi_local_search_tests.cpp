@@ -0,0 +1,138 @@
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_parallel_fi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    // Loss function with local minima, so the first improvement depends on the enumeration order:
+    struct LossFunction
+    {
+        Solution targetSolution;
+
+        int operator()(const Solution& solution) const
+        {
+            return lowerBound(solution, solution.size() - 1);
+        }
+
+        int lowerBound(const Solution& solution, std::size_t paramIndex) const
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0; i <= paramIndex; ++i)
+            {
+                int distance = std::abs(solution[i] - targetSolution[i]);
+                loss += distance * distance + (distance % 3 == 0 ? 0 : 4);
+            }
+
+            return loss;
+        }
+    };
+
+    struct NoLowerBoundLossFunction
+    {
+        LossFunction lossFunction;
+
+        int operator()(const Solution& solution) const
+        {
+            return lossFunction(solution);
+        }
+    };
+
+    struct OnImprovedSolution
+    {
+        std::vector<int>* losses;
+
+        void operator()(int, const Solution&, int improvedLoss, int) const
+        {
+            losses->push_back(improvedLoss);
+        }
+    };
+
+    template<class LossFunctionType>
+    void testParallelFI(const LossFunctionType& lossFunction, const Solution& stepSolution,
+                        const Solution& initialSolution, unsigned int threads, std::size_t windowSize)
+    {
+        std::vector<int> losses;
+        std::vector<int> parallelLosses;
+        hike::FILocalSearch<Solution, LossFunctionType, OnImprovedSolution> localSearch(
+                    lossFunction, stepSolution, OnImprovedSolution{ &losses });
+        hike::ParallelFILocalSearch<Solution, LossFunctionType, OnImprovedSolution> parallelLocalSearch(
+                    lossFunction, stepSolution, OnImprovedSolution{ &parallelLosses });
+        parallelLocalSearch.setThreadsCount(threads);
+        parallelLocalSearch.setWindowSize(windowSize);
+        REQUIRE(parallelLocalSearch.getThreadsCount() == threads);
+        REQUIRE(parallelLocalSearch.getWindowSize() == windowSize);
+
+        for(int k = 1; k <= 2; ++k)
+        {
+            localSearch.setNeighborhood(k);
+            parallelLocalSearch.setNeighborhood(k);
+
+            Solution solution = initialSolution;
+            Solution parallelSolution = initialSolution;
+            bool optimized = true;
+
+            while(optimized)
+            {
+                bool parallelOptimized;
+                solution = localSearch.optimize(solution, optimized);
+                parallelLocalSearch.optimize(Solution(parallelSolution), parallelSolution, parallelOptimized);
+                REQUIRE(parallelOptimized == optimized);
+                REQUIRE(parallelSolution == solution);
+            }
+        }
+
+        REQUIRE(parallelLosses == losses);
+    }
+}
+
+TEST_CASE("Parallel FI local search test")
+{
+    std::mt19937 random(1234);
+    std::uniform_int_distribution<int> distribution(-6, 6);
+
+    for(int problem = 0; problem < 4; ++problem)
+    {
+        LossFunction lossFunction{ Solution(5) };
+        Solution initialSolution(5);
+        Solution stepSolution(5, 1);
+        stepSolution[std::size_t(problem)] = 0;
+
+        for(std::size_t i = 0; i < 5; ++i)
+        {
+            lossFunction.targetSolution[i] = distribution(random);
+            initialSolution[i] = distribution(random);
+        }
+
+        for(unsigned int threads : { 1, 2, 4 })
+        {
+            for(std::size_t windowSize : { 1, 3, 8, 64 })
+            {
+                testParallelFI(lossFunction, stepSolution, initialSolution, threads, windowSize);
+                testParallelFI(NoLowerBoundLossFunction{ lossFunction }, stepSolution, initialSolution, threads,
+                               windowSize);
+            }
+        }
+    }
+}
+
+TEST_CASE("Parallel FI VNS test")
+{
+    using LocalSearch = hike::ParallelFILocalSearch<Solution, LossFunction>;
+    LossFunction lossFunction{ Solution{ 3, -2, 5 } };
+    LocalSearch localSearch(lossFunction, Solution{ 1, 1, 1 });
+    localSearch.setThreadsCount(2);
+
+    hike::VNS<Solution, LocalSearch> vns(std::move(localSearch), 3);
+    bool optimized;
+    Solution solution = vns.optimize(Solution{ 0, 0, 0 }, optimized);
+    REQUIRE(optimized);
+    REQUIRE(solution == Solution({ 3, -2, 5 }));
+    REQUIRE(vns.getLocalSearch().getEvaluationsCount() > 0);
+}
@@ -0,0 +1,225 @@
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_pool_allocator.h"
+#include "hike_cached_loss_function.h"
+#include "hike_ts_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    int allocations = 0;
+
+    // Allocator which counts its allocations:
+    template<class Type>
+    class CountingAllocator
+    {
+
+    public:
+        using value_type = Type;
+
+        CountingAllocator() noexcept
+        {
+        }
+
+        template<class OtherType>
+        CountingAllocator(const CountingAllocator<OtherType>&) noexcept
+        {
+        }
+
+        Type* allocate(std::size_t count)
+        {
+            ++allocations;
+            return std::allocator<Type>().allocate(count);
+        }
+
+        void deallocate(Type* pointer, std::size_t count) noexcept
+        {
+            std::allocator<Type>().deallocate(pointer, count);
+        }
+
+        template<class OtherType>
+        bool operator==(const CountingAllocator<OtherType>&) const noexcept
+        {
+            return true;
+        }
+
+        template<class OtherType>
+        bool operator!=(const CountingAllocator<OtherType>&) const noexcept
+        {
+            return false;
+        }
+    };
+
+    using Solution = std::vector<int, CountingAllocator<int>>;
+
+    struct LossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - int(i));
+            }
+
+            return loss;
+        }
+    };
+
+    template<class LocalSearch>
+    void testInPlaceOptimize(LocalSearch& localSearch)
+    {
+        Solution solution{ 3, 0, 0, 0 };
+        Solution optimizedSolution;
+        bool optimized;
+
+        // First step can allocate memory, next ones must reuse it:
+
+        localSearch.optimize(solution, optimizedSolution, optimized);
+        REQUIRE(optimized);
+
+        int warmUpAllocations = allocations;
+
+        for(int iteration = 0; iteration < 20 && optimized; ++iteration)
+        {
+            solution.swap(optimizedSolution);
+            localSearch.optimize(solution, optimizedSolution, optimized);
+        }
+
+        REQUIRE(allocations == warmUpAllocations);
+        REQUIRE(! optimized);
+        REQUIRE(optimizedSolution == Solution({ 0, 1, 2, 3 }));
+    }
+}
+
+TEST_CASE("MemoryPool test")
+{
+    hike::MemoryPool memoryPool(1024);
+    void* firstBlock = memoryPool.allocate(24);
+    void* secondBlock = memoryPool.allocate(24);
+    REQUIRE(firstBlock != secondBlock);
+
+    memoryPool.deallocate(firstBlock, 24);
+    REQUIRE(memoryPool.allocate(20) == firstBlock);
+
+    void* largeBlock = memoryPool.allocate(hike::MemoryPool::maxBlockSize + 1);
+    REQUIRE(largeBlock);
+    memoryPool.deallocate(largeBlock, hike::MemoryPool::maxBlockSize + 1);
+
+    for(int index = 0; index < 100; ++index)
+    {
+        void* block = memoryPool.allocate(100);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(block) % hike::MemoryPool::alignment == 0);
+    }
+}
+
+TEST_CASE("PoolAllocator test")
+{
+    hike::PoolAllocator<int> allocator;
+    hike::PoolAllocator<double> otherAllocator(allocator);
+    REQUIRE(allocator == otherAllocator);
+    REQUIRE(allocator != hike::PoolAllocator<int>());
+
+    std::vector<int, hike::PoolAllocator<int>> values(allocator);
+
+    for(int value = 0; value < 1000; ++value)
+    {
+        values.push_back(value);
+    }
+
+    for(int value = 0; value < 1000; ++value)
+    {
+        REQUIRE(values[std::size_t(value)] == value);
+    }
+}
+
+TEST_CASE("Cached loss functions with PoolAllocator test")
+{
+    using Array = std::array<int, 3>;
+
+    struct ArrayLossFunction
+    {
+        int operator()(const Array& solution) const
+        {
+            return std::abs(solution[0] - 2) + std::abs(solution[1] - 5) + std::abs(solution[2] + 10);
+        }
+    };
+
+    using Allocator = hike::PoolAllocator<Array>;
+    using Hash = hike::SolutionHash<Array>;
+    using CachedLossFunction = hike::CachedLossFunction<Array, ArrayLossFunction, Hash, Allocator>;
+    using TSCachedLossFunction = hike::TSCachedLossFunction<Array, ArrayLossFunction, Hash, Allocator>;
+
+    Allocator allocator;
+    Array targetSolution{{ 2, 5, -10 }};
+    Array stepSolution{{ 1, 1, 1 }};
+
+    hike::VNS<Array, hike::FILocalSearch<Array, CachedLossFunction>> vns(
+                hike::FILocalSearch<Array, CachedLossFunction>(
+                    CachedLossFunction(ArrayLossFunction(), allocator), stepSolution), 3);
+    REQUIRE(vns.optimize(Array{{ 10, -10, 10 }}) == targetSolution);
+
+    hike::VNS<Array, hike::BILocalSearch<Array, TSCachedLossFunction>> tsVNS(
+                hike::BILocalSearch<Array, TSCachedLossFunction>(
+                    TSCachedLossFunction(ArrayLossFunction(), allocator), stepSolution), 3);
+    REQUIRE(tsVNS.optimize(Array{{ 10, -10, 10 }}) == targetSolution);
+}
+
+TEST_CASE("Parallel BI solution moves with PoolAllocator test")
+{
+    using Array = std::array<int, 3>;
+
+    struct ArrayLossFunction
+    {
+        int operator()(const Array& solution) const
+        {
+            return std::abs(solution[0] - 2) + std::abs(solution[1] - 5) + std::abs(solution[2] + 10);
+        }
+
+        int operator()(const hike::SolutionMove<Array>& move) const
+        {
+            return std::abs(move.getParam(0) - 2) + std::abs(move.getParam(1) - 5) + std::abs(move.getParam(2) + 10);
+        }
+    };
+
+    using LocalSearch = hike::ParallelBILocalSearch<Array, ArrayLossFunction, hike::EmptyOnImprovedSolution,
+                                                    hike::ThreadPoolEvaluator<hike::SolutionMove<Array>,
+                                                                              ArrayLossFunction>,
+                                                    hike::PoolAllocator<Array>>;
+    Array stepSolution{{ 1, 1, 1 }};
+    hike::VNS<Array, LocalSearch> vns(LocalSearch(ArrayLossFunction(), stepSolution), 3);
+    REQUIRE(vns.optimize(Array{{ 10, -10, 10 }}) == Array({{ 2, 5, -10 }}));
+}
+
+TEST_CASE("In-place local search test")
+{
+    Solution stepSolution(4, 1);
+
+    hike::FILocalSearch<Solution, LossFunction> fiLocalSearch(LossFunction(), stepSolution);
+    testInPlaceOptimize(fiLocalSearch);
+
+    hike::BILocalSearch<Solution, LossFunction> biLocalSearch(LossFunction(), stepSolution);
+    testInPlaceOptimize(biLocalSearch);
+
+    using ParallelBILocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction, hike::EmptyOnImprovedSolution,
+                                                              hike::ThreadPoolEvaluator<Solution, LossFunction>,
+                                                              hike::PoolAllocator<Solution>>;
+    ParallelBILocalSearch parallelBILocalSearch(LossFunction(), stepSolution);
+    testInPlaceOptimize(parallelBILocalSearch);
+}
+
+TEST_CASE("VNS with in-place local search test")
+{
+    Solution stepSolution(4, 1);
+    hike::VNS<Solution, hike::BILocalSearch<Solution, LossFunction>> vns(
+                hike::BILocalSearch<Solution, LossFunction>(LossFunction(), stepSolution), 2);
+
+    Solution solution{ 5, -5, 5, -5 };
+    REQUIRE(vns.optimize(solution) == Solution({ 0, 1, 2, 3 }));
+}
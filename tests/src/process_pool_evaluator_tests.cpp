@@ -0,0 +1,228 @@
+#ifndef _WIN32
+
+#include <array>
+#include <vector>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_process_pool_evaluator.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    // Loss function which is not thread safe:
+    class LossFunction
+    {
+
+    public:
+        explicit LossFunction(const Solution& targetSolution) noexcept :
+            _targetSolution(targetSolution),
+            _diffs{{ 0, 0, 0 }}
+        {
+        }
+
+        int operator()(const Solution& solution) noexcept
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                _diffs[i] = std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            for(int diff : _diffs)
+            {
+                loss += diff;
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        Solution _diffs;
+    };
+
+    using VectorSolution = std::vector<double>;
+
+    struct VectorLossFunction
+    {
+        double operator()(const VectorSolution& solution) const noexcept
+        {
+            double loss = 0;
+
+            for(double param : solution)
+            {
+                loss += param * param;
+            }
+
+            return loss;
+        }
+    };
+
+    enum class Worker
+    {
+        SERVING,
+        FAILED,
+        OVERSIZED
+    };
+
+    int forkWorker(pid_t& pid, Worker worker)
+    {
+        int sockets[2];
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+        pid = ::fork();
+        REQUIRE(pid >= 0);
+
+        if(pid == 0)
+        {
+            ::close(sockets[0]);
+
+            if(worker == Worker::SERVING)
+            {
+                VectorLossFunction lossFunction;
+                hike::ProcessPoolEvaluator<VectorSolution, VectorLossFunction>::serve(sockets[1], lossFunction);
+            }
+            else if(worker == Worker::OVERSIZED)
+            {
+                // Reply with a payload size larger than the expected losses:
+
+                char byte;
+                std::uint64_t payloadSize = std::uint64_t(1) << 40;
+                REQUIRE(::recv(sockets[1], &byte, 1, 0) == 1);
+                REQUIRE(::send(sockets[1], &payloadSize, sizeof(payloadSize), 0) == sizeof(payloadSize));
+            }
+
+            ::close(sockets[1]);
+            ::_exit(0);
+        }
+
+        ::close(sockets[1]);
+        return sockets[0];
+    }
+
+    void testRemoteWorker(Worker worker)
+    {
+        pid_t pid;
+        VectorLossFunction lossFunction;
+        std::vector<std::pair<VectorSolution, double>> solutionsAndLosses;
+
+        {
+            hike::ProcessPoolEvaluator<VectorSolution, VectorLossFunction> evaluator(0);
+            evaluator.addWorker(forkWorker(pid, worker));
+
+            for(int index = 0; index < 100; ++index)
+            {
+                solutionsAndLosses.push_back(std::make_pair(VectorSolution(std::size_t(index % 7), index), -1.0));
+            }
+
+            for(int iteration = 0; iteration < 2; ++iteration)
+            {
+                evaluator(lossFunction, solutionsAndLosses, 0);
+
+                for(const auto& solutionAndLoss : solutionsAndLosses)
+                {
+                    REQUIRE(solutionAndLoss.second == lossFunction(solutionAndLoss.first));
+                }
+            }
+
+            REQUIRE(evaluator.getWorkersCount() == (worker == Worker::SERVING ? 1 : 0));
+        }
+
+        REQUIRE(::waitpid(pid, nullptr, 0) == pid);
+    }
+}
+
+TEST_CASE("Serializer test")
+{
+    std::vector<char> buffer;
+    hike::Serializer<Solution>::write(Solution{{ 1, -2, 3 }}, buffer);
+    hike::Serializer<VectorSolution>::write(VectorSolution{ 1.5, -2.5 }, buffer);
+
+    const char* data = buffer.data();
+    const char* dataEnd = data + buffer.size();
+    Solution solution;
+    VectorSolution vectorSolution;
+    REQUIRE(hike::Serializer<Solution>::read(data, dataEnd, solution));
+    REQUIRE(hike::Serializer<VectorSolution>::read(data, dataEnd, vectorSolution));
+    REQUIRE(! hike::Serializer<Solution>::read(data, dataEnd, solution));
+    REQUIRE(data == dataEnd);
+    REQUIRE(solution == Solution{{ 1, -2, 3 }});
+    REQUIRE(vectorSolution == VectorSolution{ 1.5, -2.5 });
+}
+
+TEST_CASE("ProcessPoolEvaluator remote worker test")
+{
+    testRemoteWorker(Worker::SERVING);
+}
+
+TEST_CASE("ProcessPoolEvaluator failed worker test")
+{
+    testRemoteWorker(Worker::FAILED);
+}
+
+TEST_CASE("ProcessPoolEvaluator oversized reply test")
+{
+    testRemoteWorker(Worker::OVERSIZED);
+}
+
+TEST_CASE("ProcessPoolEvaluator start test")
+{
+    VectorLossFunction lossFunction;
+    hike::ProcessPoolEvaluator<VectorSolution, VectorLossFunction> evaluator(2);
+    REQUIRE(evaluator.getWorkersCount() == 0);
+    REQUIRE(evaluator.start(lossFunction));
+    REQUIRE(evaluator.getWorkersCount() == 2);
+    REQUIRE(evaluator.start(lossFunction));
+    REQUIRE(evaluator.getWorkersCount() == 2);
+}
+
+TEST_CASE("ProcessPoolEvaluator multiple evaluators test")
+{
+    using Evaluator = hike::ProcessPoolEvaluator<VectorSolution, VectorLossFunction>;
+    VectorLossFunction lossFunction;
+    Evaluator secondEvaluator(1);
+
+    {
+        Evaluator firstEvaluator(1);
+        REQUIRE(firstEvaluator.start(lossFunction));
+        REQUIRE(secondEvaluator.start(lossFunction));
+
+        // Workers of the second evaluator don't keep the sockets of the first one open,
+        // so destroying it doesn't wait forever for its workers:
+    }
+
+    std::vector<std::pair<VectorSolution, double>> solutionsAndLosses(1, std::make_pair(VectorSolution(2, 3), -1.0));
+    secondEvaluator(lossFunction, solutionsAndLosses, 0);
+    REQUIRE(solutionsAndLosses[0].second == 18);
+    REQUIRE(secondEvaluator.getWorkersCount() == 1);
+}
+
+TEST_CASE("ParallelBILocalSearch VNS with ProcessPoolEvaluator")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using Evaluator = hike::ProcessPoolEvaluator<Solution, LossFunction>;
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction, hike::EmptyOnImprovedSolution, Evaluator>;
+    LocalSearch localSearch(LossFunction(targetSolution), stepSolution);
+    hike::VNS<Solution, LocalSearch> vns(std::move(localSearch), 3);
+
+    for(int p1 = -3; p1 <= 3; ++p1)
+    {
+        for(int p2 = -3; p2 <= 3; ++p2)
+        {
+            for(int p3 = -3; p3 <= 3; ++p3)
+            {
+                Solution solution{{ p1, p2, p3 }};
+                bool optimized;
+                Solution optimizedSolution = vns.optimize(solution, optimized);
+                REQUIRE(optimized == (solution != targetSolution));
+                REQUIRE(optimizedSolution == targetSolution);
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include <array>
+#include <limits>
+#include <vector>
+#include <unordered_set>
+#include <catch.hpp>
+#include "hike_solution_hash.h"
+
+namespace
+{
+    struct Point
+    {
+        int x;
+        int y;
+    };
+}
+
+namespace std
+{
+    template<>
+    struct hash<Point>
+    {
+        std::size_t operator()(const Point& point) const
+        {
+            return std::hash<int>()(point.x * 31 + point.y);
+        }
+    };
+}
+
+TEST_CASE("SolutionHash containers")
+{
+    std::array<double, 5> array{{ 1, 2, 3, 4, 5 }};
+    std::vector<double> vector{ 1, 2, 3, 4, 5 };
+    REQUIRE(hike::SolutionHash<std::array<double, 5>>()(array) == hike::SolutionHash<std::vector<double>>()(vector));
+    REQUIRE(hike::SolutionHash<std::vector<double>>()(vector) == hike::hashParams(vector.data(), vector.size()));
+
+    vector.push_back(0);
+    REQUIRE(hike::SolutionHash<std::array<double, 5>>()(array) != hike::SolutionHash<std::vector<double>>()(vector));
+}
+
+TEST_CASE("SolutionHash floating point")
+{
+    using Solution = std::vector<double>;
+    hike::SolutionHash<Solution> hash;
+
+    REQUIRE(hash(Solution{ 0.0, 1.0 }) == hash(Solution{ -0.0, 1.0 }));
+
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE(hash(Solution{ nan, 1.0 }) == hash(Solution{ -nan, 1.0 }));
+    REQUIRE(hash(Solution{ nan, 1.0 }) != hash(Solution{ 0.0, 1.0 }));
+
+    float floatZero = 0.0f;
+    float floatNegativeZero = -0.0f;
+    REQUIRE(hike::hashParams(&floatZero, 1) == hike::hashParams(&floatNegativeZero, 1));
+}
+
+TEST_CASE("SolutionHash distribution")
+{
+    for(std::size_t paramsCount = 1; paramsCount <= 9; ++paramsCount)
+    {
+        hike::SolutionHash<std::vector<int>> hash;
+        std::unordered_set<std::size_t> hashes;
+        std::unordered_set<std::size_t> lowBits;
+        std::vector<int> solution(paramsCount, 0);
+
+        for(int index = 0; index < 4096; ++index)
+        {
+            solution[index % paramsCount] += index;
+            std::size_t solutionHash = hash(solution);
+            hashes.insert(solutionHash);
+            lowBits.insert(solutionHash & 0xFFF);
+        }
+
+        REQUIRE(hashes.size() == 4096);
+        REQUIRE(lowBits.size() > 2000);
+    }
+}
+
+TEST_CASE("SolutionHash fallback")
+{
+    REQUIRE(hike::SolutionHash<int>()(5) == std::hash<int>()(5));
+    REQUIRE(hike::SolutionHash<Point>()(Point{ 1, 2 }) == std::hash<Point>()(Point{ 1, 2 }));
+}
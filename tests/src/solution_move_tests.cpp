@@ -0,0 +1,122 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    class LossFunction
+    {
+
+    public:
+        LossFunction(Solution targetSolution, std::atomic<int>& solutionCalls, std::atomic<int>& moveCalls) :
+            _targetSolution(std::move(targetSolution)),
+            _solutionCalls(solutionCalls),
+            _moveCalls(moveCalls)
+        {
+        }
+
+        int operator()(const Solution& solution) const
+        {
+            ++_solutionCalls;
+
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+        // Only the changed parameters are checked:
+        int operator()(const hike::SolutionMove<Solution>& move) const
+        {
+            ++_moveCalls;
+
+            const Solution& baseSolution = move.getBaseSolution();
+            int loss = _baseLoss(baseSolution);
+
+            for(const auto& paramChange : move)
+            {
+                int target = _targetSolution[paramChange.paramIndex];
+                loss -= std::abs(baseSolution[paramChange.paramIndex] - target);
+                loss += std::abs(paramChange.param - target);
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        std::atomic<int>& _solutionCalls;
+        std::atomic<int>& _moveCalls;
+
+        int _baseLoss(const Solution& solution) const
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+    };
+}
+
+TEST_CASE("SolutionMove test")
+{
+    using Move = hike::SolutionMove<Solution>;
+
+    Solution baseSolution{ 1, 2, 3, 4 };
+    std::vector<Move::ParamChange> paramChanges{ { 0, 7 }, { 1, 8 }, { 3, 9 } };
+    Move move(baseSolution, paramChanges, 1, 2);
+    REQUIRE(move.size() == 2);
+    REQUIRE(move[0].paramIndex == 1);
+    REQUIRE(move[1].param == 9);
+    REQUIRE(move.end() - move.begin() == 2);
+    REQUIRE(move.getParam(0) == 1);
+    REQUIRE(move.getParam(1) == 8);
+    REQUIRE(move.getParam(3) == 9);
+    REQUIRE(move.getSolution() == Solution({ 1, 8, 3, 9 }));
+    REQUIRE(&move.getBaseSolution() == &baseSolution);
+
+    REQUIRE(hike::HasMoveLoss<LossFunction, Solution>::value);
+    REQUIRE(std::is_same<hike::ParallelBICandidate<Solution, LossFunction>, Move>::value);
+}
+
+TEST_CASE("ParallelBILocalSearch with solution moves test")
+{
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction>;
+
+    std::atomic<int> solutionCalls(0);
+    std::atomic<int> moveCalls(0);
+    Solution targetSolution{ 2, -3, 1, 0 };
+    LocalSearch localSearch(LossFunction(targetSolution, solutionCalls, moveCalls), Solution(4, 1));
+
+    Solution solution{ 1, -2, 0, 0 };
+    bool optimized;
+    solution = localSearch.optimize(solution, optimized);
+    REQUIRE(optimized);
+    REQUIRE(solution == targetSolution);
+    REQUIRE(solutionCalls == 1);
+    REQUIRE(moveCalls == 80);
+
+    hike::VNS<Solution, LocalSearch> vns(std::move(localSearch), 3);
+
+    for(int p1 = -4; p1 <= 4; ++p1)
+    {
+        for(int p2 = -4; p2 <= 4; ++p2)
+        {
+            solution = vns.optimize(Solution{ p1, p2, 0, 0 }, optimized);
+            REQUIRE(solution == targetSolution);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include <vector>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_vns.h"
+#include "hike_bandit_neighborhood_schedules.h"
+#include "hike_speculative_vns.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    // Parameters must be changed all at once to decrease the loss:
+    struct LossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            int loss = std::abs(solution[0] - 5);
+
+            for(std::size_t i = 1; i < solution.size(); ++i)
+            {
+                loss += solution[i] == solution[0] ? 0 : 10;
+            }
+
+            return loss;
+        }
+    };
+
+    struct OnImprovedSolution
+    {
+        std::vector<int>* neighborhoods;
+
+        void operator()(const Solution&, int, const Solution&, int, int k) const
+        {
+            neighborhoods->push_back(k);
+        }
+    };
+
+    template<class LocalSearch, class NeighborhoodSchedule>
+    void testSpeculativeVNS(const LocalSearch& localSearch, const NeighborhoodSchedule& schedule, unsigned int threads)
+    {
+        using VNS = hike::VNS<Solution, LocalSearch, OnImprovedSolution, NeighborhoodSchedule>;
+        std::vector<int> neighborhoods;
+        VNS vns(localSearch, 5, OnImprovedSolution{ &neighborhoods }, schedule);
+
+        bool optimized;
+        Solution solution = vns.optimize(Solution(5, 0), optimized);
+        REQUIRE(optimized);
+        REQUIRE(solution == Solution(5, 5));
+
+        std::vector<int> speculativeNeighborhoods;
+        vns.getOnImprovedSolution().neighborhoods = &speculativeNeighborhoods;
+
+        hike::SpeculativeVNS<Solution, VNS> speculativeVNS(vns, threads);
+        Solution speculativeSolution = speculativeVNS.optimize(Solution(5, 0), optimized);
+        REQUIRE(optimized);
+        REQUIRE(speculativeSolution == solution);
+        REQUIRE(speculativeNeighborhoods == neighborhoods);
+
+        speculativeVNS.optimize(speculativeSolution, optimized);
+        REQUIRE(! optimized);
+    }
+
+    template<class LocalSearch>
+    void testSpeculativeVNS(const LocalSearch& localSearch)
+    {
+        for(unsigned int threads : { 1, 2, 4, 8 })
+        {
+            testSpeculativeVNS(localSearch, hike::LinearNeighborhoodSchedule(), threads);
+            testSpeculativeVNS(localSearch, hike::GeometricNeighborhoodSchedule(), threads);
+            testSpeculativeVNS(localSearch, hike::UCBNeighborhoodSchedule(), threads);
+            testSpeculativeVNS(localSearch, hike::EpsilonGreedyNeighborhoodSchedule(0.3, 1234), threads);
+        }
+    }
+}
+
+TEST_CASE("Speculative VNS test")
+{
+    testSpeculativeVNS(hike::FILocalSearch<Solution, LossFunction>(LossFunction(), Solution(5, 1)));
+    testSpeculativeVNS(hike::BILocalSearch<Solution, LossFunction>(LossFunction(), Solution(5, 1)));
+}
+
+TEST_CASE("Speculative VNS steps test")
+{
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    using VNS = hike::VNS<Solution, LocalSearch>;
+    hike::SpeculativeVNS<Solution, VNS> speculativeVNS(VNS(LocalSearch(LossFunction(), Solution(5, 1)), 5), 4);
+
+    VNS::State state = speculativeVNS.createState(Solution(5, 0));
+    int iterations = 0;
+
+    while(! speculativeVNS.iterate(state, 1))
+    {
+        ++iterations;
+    }
+
+    REQUIRE(state.optimized);
+    REQUIRE(state.solution == Solution(5, 5));
+    REQUIRE(iterations > 5);
+}
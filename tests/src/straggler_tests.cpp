@@ -0,0 +1,121 @@
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_parallel_bi_local_search.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+    using Clock = std::chrono::steady_clock;
+
+    const std::chrono::milliseconds stragglerTime(400);
+
+    // The optimal solution takes much longer to evaluate than the other ones:
+    struct LossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            int loss = std::abs(solution[0]) + std::abs(solution[1]);
+
+            std::this_thread::sleep_for(loss == 0 ? stragglerTime : std::chrono::milliseconds(5));
+
+            return loss;
+        }
+    };
+
+    struct MoveLossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            return LossFunction()(solution);
+        }
+
+        int operator()(const hike::SolutionMove<Solution>& move) const
+        {
+            return LossFunction()(move.getSolution());
+        }
+    };
+
+    template<class LocalSearch>
+    void testStragglers(LocalSearch&& localSearch)
+    {
+        // Stragglers block their threads, so more than one is needed:
+        using Evaluator = typename std::decay<decltype(localSearch.getEvaluator())>::type;
+        Evaluator evaluator(4);
+        evaluator.setDeadline(localSearch.getEvaluator().getDeadline());
+        evaluator.setQuantileCutoff(localSearch.getEvaluator().getQuantile(),
+                                    localSearch.getEvaluator().getQuantileFactor());
+        localSearch.getEvaluator() = std::move(evaluator);
+
+        Clock::time_point startTime = Clock::now();
+        bool optimized;
+        Solution solution = localSearch.optimize(Solution{ 1, 1 }, optimized);
+        REQUIRE(Clock::now() - startTime < stragglerTime);
+
+        // The optimal solution is a straggler, so the best one of the others is taken:
+        REQUIRE(optimized);
+        REQUIRE(solution == Solution({ 0, 1 }));
+    }
+}
+
+TEST_CASE("ThreadPoolEvaluator deadline test")
+{
+    hike::ThreadPoolEvaluator<Solution, LossFunction> evaluator(4);
+    REQUIRE(evaluator.getDeadline().count() == 0);
+
+    evaluator.setDeadline(std::chrono::milliseconds(50));
+    REQUIRE(evaluator.getDeadline() == std::chrono::milliseconds(50));
+
+    LossFunction lossFunction;
+    std::vector<std::pair<Solution, int>> solutionsAndLosses{
+        { Solution{ 1, 2 }, 0 }, { Solution{ 0, 0 }, 0 }, { Solution{ 0, 1 }, 0 } };
+
+    Clock::time_point startTime = Clock::now();
+    evaluator(lossFunction, solutionsAndLosses, 100);
+    REQUIRE(Clock::now() - startTime < stragglerTime);
+
+    REQUIRE(solutionsAndLosses[0] == std::make_pair(Solution{ 1, 2 }, 3));
+    REQUIRE(solutionsAndLosses[1].second == 100);
+    REQUIRE(solutionsAndLosses[2] == std::make_pair(Solution{ 0, 1 }, 1));
+}
+
+TEST_CASE("ThreadPoolEvaluator quantile cutoff test")
+{
+    hike::ThreadPoolEvaluator<Solution, LossFunction> evaluator(4);
+    evaluator.setQuantileCutoff(0.5, 2);
+    REQUIRE(evaluator.getQuantile() == 0.5);
+    REQUIRE(evaluator.getQuantileFactor() == 2);
+
+    LossFunction lossFunction;
+    std::vector<std::pair<Solution, int>> solutionsAndLosses{
+        { Solution{ 1, 2 }, 0 }, { Solution{ 0, 0 }, 0 }, { Solution{ 0, 1 }, 0 }, { Solution{ 2, 2 }, 0 } };
+
+    Clock::time_point startTime = Clock::now();
+    evaluator(lossFunction, solutionsAndLosses, 100);
+    REQUIRE(Clock::now() - startTime < stragglerTime);
+
+    REQUIRE(solutionsAndLosses[0].second == 3);
+    REQUIRE(solutionsAndLosses[1].second == 100);
+    REQUIRE(solutionsAndLosses[2].second == 1);
+    REQUIRE(solutionsAndLosses[3].second == 4);
+
+    // Without stragglers, all losses are calculated:
+    solutionsAndLosses[1].first = Solution{ 3, 3 };
+    evaluator(lossFunction, solutionsAndLosses, 100);
+    REQUIRE(solutionsAndLosses[1].second == 6);
+}
+
+TEST_CASE("ParallelBILocalSearch stragglers test")
+{
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(LossFunction(), Solution{ 1, 1 });
+    localSearch.getEvaluator().setDeadline(std::chrono::milliseconds(50));
+    testStragglers(localSearch);
+
+    using MoveLocalSearch = hike::ParallelBILocalSearch<Solution, MoveLossFunction>;
+    MoveLocalSearch moveLocalSearch(MoveLossFunction(), Solution{ 1, 1 });
+    moveLocalSearch.getEvaluator().setQuantileCutoff(0.5, 4);
+    testStragglers(moveLocalSearch);
+}
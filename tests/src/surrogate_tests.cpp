@@ -0,0 +1,120 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_bi_local_search.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 3>;
+
+    class LossFunction
+    {
+
+    public:
+        LossFunction(const Solution& targetSolution, std::atomic<int>& evaluations) noexcept :
+            _targetSolution(targetSolution),
+            _evaluations(&evaluations)
+        {
+        }
+
+        int operator()(const Solution& solution) const noexcept
+        {
+            int loss = 0;
+            ++*_evaluations;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - _targetSolution[i]);
+            }
+
+            return loss;
+        }
+
+        double surrogate(const Solution& solution) const noexcept
+        {
+            double loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                double diff = solution[i] - _targetSolution[i];
+                loss += diff * diff;
+            }
+
+            return loss;
+        }
+
+    protected:
+        Solution _targetSolution;
+        std::atomic<int>* _evaluations;
+    };
+
+    template<class LocalSearch>
+    void testVNS(LocalSearch& localSearch, const Solution& targetSolution, const std::atomic<int>& evaluations)
+    {
+        int candidatesEvaluations = 0;
+        int surrogateEvaluations = 0;
+
+        for(std::size_t surrogateCandidates : { std::size_t(0), std::size_t(3) })
+        {
+            localSearch.setSurrogateCandidates(surrogateCandidates);
+
+            hike::VNS<Solution, LocalSearch&> vns(localSearch, 3);
+            int initialEvaluations = evaluations;
+
+            for(int p1 = -5; p1 <= 5; ++p1)
+            {
+                for(int p2 = -5; p2 <= 5; ++p2)
+                {
+                    for(int p3 = -5; p3 <= 5; ++p3)
+                    {
+                        Solution solution{{ p1, p2, p3 }};
+                        bool optimized;
+                        Solution optimizedSolution = vns.optimize(solution, optimized);
+                        REQUIRE(optimized == (solution != targetSolution));
+                        REQUIRE(optimizedSolution == targetSolution);
+                    }
+                }
+            }
+
+            if(surrogateCandidates)
+            {
+                surrogateEvaluations = evaluations - initialEvaluations;
+            }
+            else
+            {
+                candidatesEvaluations = evaluations - initialEvaluations;
+            }
+        }
+
+        REQUIRE(surrogateEvaluations * 2 < candidatesEvaluations);
+    }
+}
+
+TEST_CASE("HasSurrogate test")
+{
+    REQUIRE(hike::HasSurrogate<LossFunction, Solution>::value);
+    REQUIRE((std::is_same<hike::SurrogateLossType<LossFunction, Solution>, double>::value));
+}
+
+TEST_CASE("BILocalSearch VNS with surrogate losses")
+{
+    std::atomic<int> evaluations(0);
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using LocalSearch = hike::BILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(LossFunction(targetSolution, evaluations), stepSolution);
+    testVNS(localSearch, targetSolution, evaluations);
+}
+
+TEST_CASE("ParallelBILocalSearch VNS with surrogate losses")
+{
+    std::atomic<int> evaluations(0);
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(LossFunction(targetSolution, evaluations), stepSolution);
+    testVNS(localSearch, targetSolution, evaluations);
+}
@@ -1,5 +1,11 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
 #include <catch.hpp>
 #include "hike_thread_pool.h"
+#include "hike_parallel_bi_local_search.h"
 
 TEST_CASE("Empty ThreadPool test")
 {
@@ -42,3 +48,97 @@ TEST_CASE("ThreadPool test")
         REQUIRE(param == 1);
     }
 }
+
+TEST_CASE("ThreadPool wait strategies test")
+{
+    struct Task
+    {
+        int& param;
+
+        void operator()()
+        {
+            ++param;
+        }
+    };
+
+    hike::ThreadPool<Task> threadPool(2);
+    std::vector<int> params(100, 0);
+    REQUIRE(! threadPool.isCallerParticipationEnabled());
+
+    for(int spinCount : { 0, 1000 })
+    {
+        for(bool callerParticipation : { false, true })
+        {
+            threadPool.setSpinCount(spinCount);
+            threadPool.setCallerParticipationEnabled(callerParticipation);
+            REQUIRE(threadPool.getSpinCount() == spinCount);
+            REQUIRE(threadPool.isCallerParticipationEnabled() == callerParticipation);
+
+            for(int iteration = 0; iteration < 100; ++iteration)
+            {
+                for(int& param : params)
+                {
+                    threadPool.add(Task{param});
+                }
+
+                threadPool.join();
+            }
+        }
+    }
+
+    for(int param : params)
+    {
+        REQUIRE(param == 400);
+    }
+}
+
+TEST_CASE("ParallelBILocalSearch caller participation test")
+{
+    using Solution = std::array<int, 3>;
+
+    // Slow loss function which counts the losses calculated in the calling thread:
+    struct LossFunction
+    {
+        std::thread::id callerThreadId;
+        std::atomic<int>* callerEvaluations;
+
+        int operator()(const Solution& solution) const
+        {
+            if(std::this_thread::get_id() == callerThreadId)
+            {
+                ++*callerEvaluations;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return std::abs(solution[0] - 3) + std::abs(solution[1] + 2) + std::abs(solution[2] - 1);
+        }
+    };
+
+    using Evaluator = hike::ThreadPoolEvaluator<Solution, LossFunction>;
+    using LocalSearch = hike::ParallelBILocalSearch<Solution, LossFunction>;
+    std::atomic<int> callerEvaluations(0);
+    int evaluations[2];
+
+    for(bool callerParticipation : { false, true })
+    {
+        LocalSearch localSearch(LossFunction{ std::this_thread::get_id(), &callerEvaluations }, Solution{{ 1, 1, 1 }});
+        Evaluator& evaluator = localSearch.getEvaluator();
+        evaluator = Evaluator(1);
+        REQUIRE(! evaluator.isCallerParticipationEnabled());
+
+        evaluator.setSpinCount(0);
+        evaluator.setCallerParticipationEnabled(callerParticipation);
+        REQUIRE(evaluator.getSpinCount() == 0);
+        REQUIRE(evaluator.isCallerParticipationEnabled() == callerParticipation);
+
+        bool optimized;
+        callerEvaluations = 0;
+        localSearch.optimize(Solution{{ 0, 0, 0 }}, optimized);
+        REQUIRE(optimized);
+        evaluations[callerParticipation] = callerEvaluations;
+    }
+
+    // Candidates are added much faster than the only worker thread evaluates them,
+    // so the calling thread evaluates some of them when it participates:
+    REQUIRE(evaluations[1] > evaluations[0]);
+}
@@ -1,4 +1,5 @@
 #include <array>
+#include <cstdlib>
 #include <catch.hpp>
 #include "hike_fi_local_search.h"
 #include "hike_bi_local_search.h"
@@ -56,6 +57,19 @@ namespace
             }
         }
     }
+
+    template<class LocalSearch>
+    Solution findLocalOptimum(LocalSearch& localSearch, Solution solution)
+    {
+        bool optimized = true;
+
+        while(optimized)
+        {
+            solution = localSearch.optimize(solution, optimized);
+        }
+
+        return solution;
+    }
 }
 
 TEST_CASE("3D FILocalSearch VNS")
@@ -68,6 +82,69 @@ TEST_CASE("3D FILocalSearch VNS")
     testVNS(localSearch, targetSolution);
 }
 
+TEST_CASE("3D FILocalSearch VNS with don't look bits")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    LossFunction lossFunction(targetSolution);
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(lossFunction, stepSolution);
+    localSearch.setDontLookBitsEnabled(true);
+    testVNS(localSearch, targetSolution);
+
+    // Searching a local optimum again skips the parameters which didn't improve it:
+
+    LocalSearch plainLocalSearch(lossFunction, stepSolution);
+    Solution solution{{ -10, 10, -10 }};
+    Solution localOptimum = findLocalOptimum(localSearch, solution);
+    REQUIRE(localOptimum == targetSolution);
+    REQUIRE(findLocalOptimum(plainLocalSearch, solution) == targetSolution);
+    localSearch.resetEvaluationsCount();
+    plainLocalSearch.resetEvaluationsCount();
+    REQUIRE(findLocalOptimum(localSearch, localOptimum) == targetSolution);
+    REQUIRE(findLocalOptimum(plainLocalSearch, localOptimum) == targetSolution);
+    REQUIRE(localSearch.getEvaluationsCount() < plainLocalSearch.getEvaluationsCount());
+}
+
+TEST_CASE("3D FILocalSearch VNS with move ordering")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    LossFunction lossFunction(targetSolution);
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(lossFunction, stepSolution);
+    localSearch.setMoveOrderingEnabled(true);
+    testVNS(localSearch, targetSolution);
+
+    // When the target drifts the same way, the direction which improved the previous search is tried first:
+
+    LocalSearch plainLocalSearch(lossFunction, stepSolution);
+    Solution solution{{ -10, -10, -20 }};
+    REQUIRE(findLocalOptimum(localSearch, solution) == targetSolution);
+    REQUIRE(findLocalOptimum(plainLocalSearch, solution) == targetSolution);
+
+    Solution driftedTargetSolution{{ 12, 15, 0 }};
+    localSearch.getLossFunction() = LossFunction(driftedTargetSolution);
+    plainLocalSearch.getLossFunction() = LossFunction(driftedTargetSolution);
+    localSearch.resetEvaluationsCount();
+    plainLocalSearch.resetEvaluationsCount();
+    REQUIRE(findLocalOptimum(localSearch, targetSolution) == driftedTargetSolution);
+    REQUIRE(findLocalOptimum(plainLocalSearch, targetSolution) == driftedTargetSolution);
+    REQUIRE(localSearch.getEvaluationsCount() < plainLocalSearch.getEvaluationsCount());
+}
+
+TEST_CASE("3D FILocalSearch VNS with don't look bits and move ordering")
+{
+    Solution targetSolution{{ 2, 5, -10 }};
+    Solution stepSolution{{ 1, 1, 1 }};
+    LossFunction lossFunction(targetSolution);
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    LocalSearch localSearch(lossFunction, stepSolution);
+    localSearch.setDontLookBitsEnabled(true);
+    localSearch.setMoveOrderingEnabled(true);
+    testVNS(localSearch, targetSolution);
+}
+
 TEST_CASE("3D BILocalSearch VNS")
 {
     Solution targetSolution{{ 2, 5, -10 }};
@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_parallel_bi_local_search.h"
+#include "hike_vns.h"
+#include "hike_vnds.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    struct LossFunction
+    {
+        int operator()(const Solution& solution) const
+        {
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                loss += std::abs(solution[i] - int(i % 7) + 3);
+            }
+
+            return loss;
+        }
+    };
+
+    Solution targetSolution(std::size_t size)
+    {
+        Solution solution(size);
+
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            solution[i] = int(i % 7) - 3;
+        }
+
+        return solution;
+    }
+
+    template<class LocalSearch>
+    void testFrozenParams(LocalSearch&& localSearch)
+    {
+        localSearch.setStepSolution(Solution{ 1, 0, 1, 0 });
+        REQUIRE(localSearch.getStepSolution() == Solution({ 1, 0, 1, 0 }));
+
+        Solution solution{ 2, 2, 2, 2 };
+
+        for(int iteration = 0; iteration < 10; ++iteration)
+        {
+            solution = localSearch.optimize(solution);
+        }
+
+        REQUIRE(solution == Solution({ -3, 2, -1, 2 }));
+    }
+
+    template<class LocalSearch>
+    void testVNDS(LocalSearch&& localSearch, std::size_t size)
+    {
+        using VNS = hike::VNS<Solution, typename std::decay<LocalSearch>::type>;
+        hike::VNDS<Solution, VNS> vnds(VNS(std::forward<LocalSearch>(localSearch), 2), Solution(size, 1), 3);
+        vnds.setSeed(1234);
+        REQUIRE(vnds.getMaxParams() == 3);
+
+        bool optimized;
+        Solution solution = vnds.optimize(Solution(size, 5), optimized);
+        REQUIRE(optimized);
+        REQUIRE(solution == targetSolution(size));
+        REQUIRE(vnds.getVNS().getLocalSearch().getStepSolution() == Solution(size, 1));
+
+        solution = vnds.optimize(solution, optimized);
+        REQUIRE(! optimized);
+    }
+}
+
+TEST_CASE("Frozen params test")
+{
+    testFrozenParams(hike::FILocalSearch<Solution, LossFunction>(LossFunction(), Solution(4, 1)));
+    testFrozenParams(hike::BILocalSearch<Solution, LossFunction>(LossFunction(), Solution(4, 1)));
+    testFrozenParams(hike::ParallelBILocalSearch<Solution, LossFunction>(LossFunction(), Solution(4, 1)));
+}
+
+TEST_CASE("VNDS test")
+{
+    std::size_t size = 300;
+    testVNDS(hike::FILocalSearch<Solution, LossFunction>(LossFunction(), Solution(size, 1)), size);
+    testVNDS(hike::BILocalSearch<Solution, LossFunction>(LossFunction(), Solution(size, 1)), size);
+}
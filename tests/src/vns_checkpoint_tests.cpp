@@ -0,0 +1,196 @@
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_cached_loss_function.h"
+#include "hike_ts_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_vns.h"
+#include "hike_bandit_neighborhood_schedules.h"
+#include "hike_vns_checkpoint.h"
+
+namespace
+{
+    using Solution = std::vector<int>;
+
+    struct LossFunction
+    {
+        int* evaluations;
+
+        int operator()(const Solution& solution) const
+        {
+            ++*evaluations;
+
+            int loss = 0;
+
+            for(std::size_t i = 0, l = solution.size(); i < l; ++i)
+            {
+                int distance = std::abs(solution[i] - int(i * 3));
+                loss += distance * distance + (distance % 2) * 3;
+            }
+
+            return loss;
+        }
+    };
+
+    using LocalSearch = hike::FILocalSearch<Solution, LossFunction>;
+    using VNS = hike::VNS<Solution, LocalSearch, hike::EmptyOnImprovedSolution, hike::EpsilonGreedyNeighborhoodSchedule>;
+    using Checkpoint = hike::VNSCheckpoint<Solution, VNS>;
+
+    VNS createVNS(int& evaluations)
+    {
+        return VNS(LocalSearch(LossFunction{ &evaluations }, Solution(4, 1)), 4, hike::EmptyOnImprovedSolution(),
+                   hike::EpsilonGreedyNeighborhoodSchedule(0.5, 1234));
+    }
+
+    const char* checkpointFilePath = "hike_vns_checkpoint_test.bin";
+}
+
+TEST_CASE("VNS checkpoint test")
+{
+    std::remove(checkpointFilePath);
+
+    int evaluations = 0;
+    VNS vns = createVNS(evaluations);
+    Solution expectedSolution = vns.optimize(Solution(4, 20));
+
+    // Interrupt an optimization process after a few local searches:
+    VNS::State state = vns.createState(Solution(4, 20));
+    vns.iterate(state, 3);
+
+    Checkpoint checkpoint(checkpointFilePath);
+    REQUIRE(checkpoint.getFilePath() == checkpointFilePath);
+    REQUIRE(checkpoint.save(state, std::vector<char>{ 'a', 'b' }));
+
+    // Resume it with other objects:
+    int resumedEvaluations = 0;
+    VNS resumedVNS = createVNS(resumedEvaluations);
+    Checkpoint resumedCheckpoint(checkpointFilePath);
+    VNS::State resumedState = VNS::State();
+    std::vector<char> userData;
+    REQUIRE(resumedCheckpoint.load(resumedState, &userData));
+    REQUIRE(resumedEvaluations == 0);
+    REQUIRE(userData == std::vector<char>({ 'a', 'b' }));
+    REQUIRE(resumedState.solution == state.solution);
+    REQUIRE(resumedState.loss == state.loss);
+    REQUIRE(resumedState.k == state.k);
+    REQUIRE(resumedState.scheduleState.pulls == state.scheduleState.pulls);
+    REQUIRE(resumedState.scheduleState.random == state.scheduleState.random);
+
+    while(! resumedVNS.iterate(resumedState, 1))
+    {
+    }
+
+    REQUIRE(resumedState.solution == expectedSolution);
+    std::remove(checkpointFilePath);
+}
+
+TEST_CASE("VNS checkpoint optimize test")
+{
+    std::remove(checkpointFilePath);
+
+    int evaluations = 0;
+    VNS vns = createVNS(evaluations);
+    Solution expectedSolution = vns.optimize(Solution(4, 20));
+
+    Checkpoint checkpoint(checkpointFilePath);
+    VNS::State state = VNS::State();
+    REQUIRE(! checkpoint.load(state));
+
+    bool optimized;
+    REQUIRE(checkpoint.optimize(vns, Solution(4, 20), 2, optimized) == expectedSolution);
+    REQUIRE(optimized);
+    REQUIRE(! checkpoint.hasSaveFailed());
+
+    // A finished optimization process is not resumed, so the given solution is optimized:
+    REQUIRE(! checkpoint.load(state));
+    REQUIRE(checkpoint.optimize(vns, Solution(4, 0), 2, optimized) == vns.optimize(Solution(4, 0)));
+
+    // An interrupted optimization process is resumed, so the given solution is ignored:
+    state = vns.createState(Solution(4, 20));
+    vns.iterate(state, 3);
+    REQUIRE(checkpoint.save(state));
+    REQUIRE(checkpoint.optimize(vns, Solution(4, 0), 2, optimized) == expectedSolution);
+    REQUIRE(! checkpoint.load(state));
+
+    // Checkpoints which can't be saved are reported:
+    Checkpoint failedCheckpoint("hike_missing_directory/hike_vns_checkpoint_test.bin");
+    REQUIRE(failedCheckpoint.optimize(vns, Solution(4, 20), 2, optimized) == expectedSolution);
+    REQUIRE(failedCheckpoint.hasSaveFailed());
+}
+
+TEST_CASE("Bandit neighborhood schedule state serializer test")
+{
+    hike::BanditNeighborhoodScheduleState state;
+    state.arms.push_back(hike::BanditNeighborhoodArm{ 3, 40, 2.5, true });
+    state.arms.push_back(hike::BanditNeighborhoodArm{ 1, 7, 0, false });
+    state.pulls = 4;
+    state.random.seed(1234);
+
+    std::vector<char> buffer;
+    hike::Serializer<hike::BanditNeighborhoodArm>::write(state.arms[0], buffer);
+
+    // Arm fields are written one by one, without padding bytes:
+    REQUIRE(buffer.size() == sizeof(std::uint64_t) * 2 + sizeof(double) + sizeof(bool));
+
+    buffer.clear();
+    hike::Serializer<hike::BanditNeighborhoodScheduleState>::write(state, buffer);
+
+    const char* data = buffer.data();
+    const char* dataEnd = data + buffer.size();
+    hike::BanditNeighborhoodScheduleState readState;
+    REQUIRE(hike::Serializer<hike::BanditNeighborhoodScheduleState>::read(data, dataEnd, readState));
+    REQUIRE(data == dataEnd);
+    REQUIRE(readState.arms.size() == 2);
+    REQUIRE(readState.arms[0].pulls == 3);
+    REQUIRE(readState.arms[0].evaluations == 40);
+    REQUIRE(readState.arms[0].improvement == 2.5);
+    REQUIRE(readState.arms[0].failed);
+    REQUIRE(readState.arms[1].pulls == 1);
+    REQUIRE(! readState.arms[1].failed);
+    REQUIRE(readState.pulls == 4);
+    REQUIRE(readState.random == state.random);
+
+    // Truncated states are rejected:
+    data = buffer.data();
+    REQUIRE(! hike::Serializer<hike::BanditNeighborhoodScheduleState>::read(data, data + 20, readState));
+}
+
+TEST_CASE("Loss cache save and load test")
+{
+    int evaluations = 0;
+    hike::CachedLossFunction<Solution, LossFunction> cache(LossFunction{ &evaluations });
+    hike::TSCachedLossFunction<Solution, LossFunction> tsCache(LossFunction{ &evaluations });
+    std::vector<Solution> solutions{ Solution{ 1, 2 }, Solution{ 3, 4 }, Solution{ 5, 6 } };
+
+    for(const Solution& solution : solutions)
+    {
+        cache(solution);
+        tsCache(solution);
+    }
+
+    std::vector<char> buffer;
+    cache.save(buffer);
+    tsCache.save(buffer);
+
+    int loadedEvaluations = 0;
+    hike::CachedLossFunction<Solution, LossFunction> loadedCache(LossFunction{ &loadedEvaluations });
+    hike::TSCachedLossFunction<Solution, LossFunction> loadedTSCache(LossFunction{ &loadedEvaluations });
+    const char* data = buffer.data();
+    const char* dataEnd = data + buffer.size();
+    REQUIRE(loadedCache.load(data, dataEnd));
+    REQUIRE(loadedTSCache.load(data, dataEnd));
+    REQUIRE(data == dataEnd);
+
+    for(const Solution& solution : solutions)
+    {
+        REQUIRE(loadedCache(solution) == cache(solution));
+        REQUIRE(loadedTSCache(solution) == tsCache(solution));
+    }
+
+    REQUIRE(loadedEvaluations == 0);
+
+    // Truncated data is rejected:
+    data = buffer.data();
+    REQUIRE(! loadedCache.load(data, data + buffer.size() / 4));
+}
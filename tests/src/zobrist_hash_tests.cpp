@@ -0,0 +1,161 @@
+#include <array>
+#include <random>
+#include <cstdlib>
+#include <catch.hpp>
+#include "hike_zobrist_hash.h"
+#include "hike_cached_loss_function.h"
+#include "hike_ts_cached_loss_function.h"
+#include "hike_fi_local_search.h"
+#include "hike_bi_local_search.h"
+#include "hike_vns.h"
+
+namespace
+{
+    using Solution = std::array<int, 4>;
+    using ZobristHash = hike::ZobristHash<Solution>;
+
+    struct LossFunction
+    {
+        Solution targetSolution;
+        int* evaluations;
+
+        int operator()(const Solution& solution) const
+        {
+            ++*evaluations;
+
+            int loss = 0;
+
+            for(std::size_t i = 0; i < solution.size(); ++i)
+            {
+                loss += std::abs(solution[i] - targetSolution[i]);
+            }
+
+            return loss;
+        }
+    };
+
+    struct HashCheckLossFunction
+    {
+        LossFunction lossFunction;
+        int* hashedEvaluations;
+
+        int operator()(const Solution& solution) const
+        {
+            return lossFunction(solution);
+        }
+
+        int hashedLoss(const hike::HashedSolution<Solution>& hashedSolution, int)
+        {
+            // The rolling hash of the local search must match the hash of the whole solution:
+            REQUIRE(hashedSolution.hash == ZobristHash()(hashedSolution.solution));
+
+            ++*hashedEvaluations;
+            return lossFunction(hashedSolution.solution);
+        }
+    };
+
+    template<class LocalSearch>
+    void testRollingHash(LocalSearch&& localSearch)
+    {
+        hike::VNS<Solution, LocalSearch> vns(std::move(localSearch), 3);
+        REQUIRE(vns.optimize(Solution{{ 0, 0, 0, 0 }}) == Solution({{ 4, -3, 2, 7 }}));
+    }
+
+    template<class CachedLossFunction>
+    void testCache()
+    {
+        int evaluations = 0;
+        CachedLossFunction cachedLossFunction(LossFunction{ Solution{{ 4, -3, 2, 7 }}, &evaluations });
+        Solution solution{{ 1, 2, 3, 4 }};
+        REQUIRE(cachedLossFunction(solution) == 12);
+        REQUIRE(evaluations == 1);
+
+        std::size_t hash = ZobristHash()(solution);
+        REQUIRE(cachedLossFunction.hashedLoss(hike::HashedSolution<Solution>{ solution, hash }, 100) == 12);
+        REQUIRE(evaluations == 1);
+
+        // Cache lookups use the given hash instead of hashing the solution again,
+        // so a wrong hash doesn't find the cached loss:
+
+        REQUIRE(cachedLossFunction.hashedLoss(hike::HashedSolution<Solution>{ solution, hash + 1 }, 100) == 12);
+        REQUIRE(evaluations == 2);
+    }
+}
+
+TEST_CASE("ZobristHash update")
+{
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    Solution solution{{ 0, 0, 0, 0 }};
+    std::size_t hash = ZobristHash()(solution);
+
+    for(int index = 0; index < 1000; ++index)
+    {
+        std::size_t paramIndex = std::size_t(index) % solution.size();
+        int oldParam = solution[paramIndex];
+        solution[paramIndex] = distribution(random);
+        hash = ZobristHash::update(hash, paramIndex, oldParam, solution[paramIndex]);
+        REQUIRE(hash == ZobristHash()(solution));
+    }
+
+    REQUIRE(ZobristHash()(Solution{{ 1, 2, 0, 0 }}) != ZobristHash()(Solution{{ 2, 1, 0, 0 }}));
+    REQUIRE(hike::ZobristHash<std::array<double, 1>>()({{ 0.0 }}) ==
+            hike::ZobristHash<std::array<double, 1>>()({{ -0.0 }}));
+}
+
+TEST_CASE("ZobristHash local searches")
+{
+    int evaluations = 0;
+    int hashedEvaluations = 0;
+    HashCheckLossFunction lossFunction{ LossFunction{ Solution{{ 4, -3, 2, 7 }}, &evaluations }, &hashedEvaluations };
+    Solution stepSolution{{ 1, 1, 1, 1 }};
+
+    testRollingHash(hike::FILocalSearch<Solution, HashCheckLossFunction>(lossFunction, stepSolution));
+    REQUIRE(hashedEvaluations > 0);
+
+    hashedEvaluations = 0;
+    hike::FILocalSearch<Solution, HashCheckLossFunction> fiLocalSearch(lossFunction, stepSolution);
+    fiLocalSearch.setDontLookBitsEnabled(true);
+    fiLocalSearch.setMoveOrderingEnabled(true);
+    testRollingHash(std::move(fiLocalSearch));
+    REQUIRE(hashedEvaluations > 0);
+
+    hashedEvaluations = 0;
+    testRollingHash(hike::BILocalSearch<Solution, HashCheckLossFunction>(lossFunction, stepSolution));
+    REQUIRE(hashedEvaluations > 0);
+}
+
+TEST_CASE("ZobristHash caches")
+{
+    // Only caches which identify solutions with ZobristHash support hashed solutions:
+
+    REQUIRE(hike::HasHashedLoss<hike::CachedLossFunction<Solution, LossFunction, ZobristHash>, Solution>::value);
+    REQUIRE(hike::HasHashedLoss<hike::TSCachedLossFunction<Solution, LossFunction, ZobristHash>, Solution>::value);
+    REQUIRE(! hike::HasHashedLoss<hike::CachedLossFunction<Solution, LossFunction>, Solution>::value);
+    REQUIRE(! hike::HasHashedLoss<hike::TSCachedLossFunction<Solution, LossFunction>, Solution>::value);
+
+    testCache<hike::CachedLossFunction<Solution, LossFunction, ZobristHash>>();
+    testCache<hike::TSCachedLossFunction<Solution, LossFunction, ZobristHash>>();
+
+    // Caches with the same evaluations with and without rolling hashes:
+
+    int evaluations = 0;
+    int zobristEvaluations = 0;
+    Solution targetSolution{{ 4, -3, 2, 7 }};
+    Solution stepSolution{{ 1, 1, 1, 1 }};
+
+    using CachedLossFunction = hike::CachedLossFunction<Solution, LossFunction>;
+    using LocalSearch = hike::FILocalSearch<Solution, CachedLossFunction>;
+    hike::VNS<Solution, LocalSearch> vns(LocalSearch(CachedLossFunction(LossFunction{ targetSolution, &evaluations }),
+                                                     stepSolution), 3);
+
+    using ZobristLossFunction = hike::CachedLossFunction<Solution, LossFunction, ZobristHash>;
+    using ZobristLocalSearch = hike::FILocalSearch<Solution, ZobristLossFunction>;
+    hike::VNS<Solution, ZobristLocalSearch> zobristVNS(
+                ZobristLocalSearch(ZobristLossFunction(LossFunction{ targetSolution, &zobristEvaluations }),
+                                   stepSolution), 3);
+
+    REQUIRE(vns.optimize(Solution{{ 0, 0, 0, 0 }}) == targetSolution);
+    REQUIRE(zobristVNS.optimize(Solution{{ 0, 0, 0, 0 }}) == targetSolution);
+    REQUIRE(evaluations == zobristEvaluations);
+}